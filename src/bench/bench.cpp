@@ -0,0 +1,111 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include <QDateTime>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+Bench::Bench()
+    : m_fMinTime(0.1)
+    , m_iRepetitions(5)
+{
+}
+
+bool Bench::enabled(const std::string& name) const
+{
+    return m_sFilter.empty() || name.find(m_sFilter) != std::string::npos;
+}
+
+double Bench::measure(const Body& body, uint64_t iterations)
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+    body(iterations);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Bench::run(const std::string& name, const Params& params, const Body& body)
+{
+    if (!enabled(name)) {
+        return;
+    }
+
+    // warm up and calibrate
+    uint64_t iterations = 1;
+    double elapsed = measure(body, iterations);
+    while (elapsed < m_fMinTime && iterations < (UINT64_C(1) << 40)) {
+        // aim a bit above the target to avoid too many rounds
+        const double factor = elapsed > 0 ? 1.4 * m_fMinTime / elapsed : 10.0;
+        iterations = std::max(iterations + 1, (uint64_t) (iterations * std::min(factor, 10.0)));
+        elapsed = measure(body, iterations);
+    }
+
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(m_iRepetitions);
+    for (int r = 0; r < m_iRepetitions; ++r) {
+        nsPerOp.push_back(1e9 * measure(body, iterations) / iterations);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    double mean = 0;
+    for (size_t i = 0; i < nsPerOp.size(); ++i) {
+        mean += nsPerOp[i];
+    }
+    mean /= nsPerOp.size();
+    const double median = nsPerOp[nsPerOp.size() / 2];
+
+    QJsonObject jsonParams;
+    std::string label = name;
+    for (size_t i = 0; i < params.size(); ++i) {
+        jsonParams.insert(QString::fromStdString(params[i].first), (qint64) params[i].second);
+        label += " " + params[i].first + "=" + std::to_string(params[i].second);
+    }
+
+    QJsonObject ns;
+    ns.insert("min", nsPerOp.front());
+    ns.insert("median", median);
+    ns.insert("mean", mean);
+
+    QJsonObject result;
+    result.insert("name", QString::fromStdString(name));
+    result.insert("params", jsonParams);
+    result.insert("iterations", (qint64) iterations);
+    result.insert("ns_per_op", ns);
+    m_results.append(result);
+
+    // progress goes to stderr; stdout is kept for the json
+    std::cerr << label << ": " << median << " ns/op" << std::endl;
+}
+
+QJsonObject Bench::toJson() const
+{
+    QJsonObject context;
+    context.insert("date", QDateTime::currentDateTime().toString(Qt::ISODate));
+    context.insert("threads", QThread::idealThreadCount());
+    context.insert("min_time", m_fMinTime);
+    context.insert("repetitions", m_iRepetitions);
+
+    QJsonObject json;
+    json.insert("context", context);
+    json.insert("benchmarks", m_results);
+    return json;
+}
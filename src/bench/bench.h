@@ -0,0 +1,77 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// keep the compiler from optimizing away a value computed in a benchmark
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief The Bench class
+ * A minimal benchmark harness. Each body is run 'iterations' times in a row;
+ * the number of iterations is calibrated so that each repetition takes at
+ * least 'minTime' seconds. The time per operation (in nanoseconds) of each
+ * repetition is summarized as min/median/mean.
+ * @author KilobotGA contributors
+ */
+class Bench
+{
+
+public:
+    typedef std::vector<std::pair<std::string, int64_t> > Params;
+    typedef std::function<void(uint64_t iterations)> Body;
+
+    Bench();
+
+    inline void setMinTime(double seconds) { m_fMinTime = seconds; }
+    inline void setRepetitions(int repetitions) { m_iRepetitions = repetitions; }
+    // only run the benchmarks whose name contains 'filter'
+    inline void setFilter(const std::string& filter) { m_sFilter = filter; }
+
+    bool enabled(const std::string& name) const;
+    void run(const std::string& name, const Params& params, const Body& body);
+
+    // all results so far
+    inline const QJsonArray& results() const { return m_results; }
+    QJsonObject toJson() const;
+
+private:
+    double m_fMinTime;
+    int m_iRepetitions;
+    std::string m_sFilter;
+    QJsonArray m_results;
+
+    // seconds spent running the body 'iterations' times
+    static double measure(const Body& body, uint64_t iterations);
+};
+
+#endif // BENCH_H
@@ -0,0 +1,546 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * kga_bench: microbenchmarks of the genetic operators, the storage of the
+ * generations, the random streams and the control step of the controllers. Nothing is simulated;
+ * controllers run on mock devices and receive synthetic packets.
+ *
+ * usage: kga_bench [--quick] [--check] [--filter <substring>] [--min-time <seconds>] [--out <file>]
+ *
+ * The results are printed as JSON (stdout by default). Whatever the filter,
+ * the control steps are first checked for heap allocations: if any, it exits
+ * with status 2. --check only runs this check (it is the 'control_step_allocations'
+ * test of CTest).
+ */
+
+#include "bench.h"
+
+#include "controllers/demo_ctrl.h"
+#include "controllers/mock_devices.h"
+#include "controllers/pd_ctrl.h"
+#include "controllers/random_stream.h"
+#include "loop_functions/demo_lf.h"
+#include "loop_functions/genetic_operators.h"
+#include "loop_functions/pd_lf.h"
+#include "loop_functions/population.h"
+#include "loop_functions/population_archive.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#define BENCH_SEED 42
+
+// control steps run by the allocation check
+#define ALLOC_CHECK_STEPS 1000
+
+// every heap allocation of the process is counted
+static std::atomic<uint64_t> s_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t) noexcept { free(p); }
+
+// false if a control step allocated memory
+static bool s_allocationFree = true;
+
+static std::vector<size_t> s_popSizes;
+static std::vector<size_t> s_lutSizes;
+static std::vector<size_t> s_packetCounts;
+
+/**
+ * @brief The MockRobot struct
+ * A controller of type C bound to mock devices.
+ */
+template <typename C>
+struct MockRobot {
+    MockDevices devices;
+    C controller;
+
+    explicit MockRobot(TConfigurationNode& params) {
+        devices.attach(controller);
+        controller.Init(params);
+    }
+};
+
+static std::vector<float> randFitness(CRandom::CRNG* rng, size_t popSize)
+{
+    std::vector<float> fitness(popSize);
+    for (size_t i = 0; i < popSize; ++i) {
+        fitness[i] = (float) rng->Uniform(CRange<Real>(0, 100));
+    }
+    return fitness;
+}
+
+// a population of random genes drawn by the given controller
+static void randPopulation(const AbstractGACtrl& ctrl, size_t popSize, size_t length, Population& population)
+{
+    population.allocate(popSize, ctrl.geneSize(), length);
+    for (size_t i = 0; i < popSize; ++i) {
+        ChromosomeView c = population.current(i);
+        for (size_t g = 0; g < length; ++g) {
+            ctrl.fillRandGene(c.at(g));
+        }
+    }
+}
+
+// one draw per op, as in randWalk(); the streams of the robots against
+// the shared generator of ARGoS
+static void benchRandom(Bench& bench, CRandom::CRNG* rng)
+{
+    const CRange<UInt32> ticks(1, 15);
+    bench.run("rng/argos_uniform", {}, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            doNotOptimize(rng->Uniform(ticks));
+        }
+    });
+
+    RandomStream stream;
+    stream.setKey(BENCH_SEED, 0);
+    bench.run("rng/philox_uniform", {}, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            doNotOptimize(stream.uniform(ticks));
+        }
+    });
+
+    // random access: a new robot/generation every op
+    bench.run("rng/philox_seek", {}, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            stream.setCounter((uint32_t) i, 0);
+            doNotOptimize(stream.next());
+        }
+    });
+}
+
+static void benchOperators(Bench& bench, CRandom::CRNG* rng)
+{
+    GeneticOperators ops;
+    ops.setRNG(rng);
+    ops.setTournamentSize(2);
+    ops.setCrossoverRate(0.5f);
+    ops.setMutationRate(0.05f);
+
+    for (size_t p = 0; p < s_popSizes.size(); ++p) {
+        const size_t popSize = s_popSizes[p];
+        const std::vector<float> fitness = randFitness(rng, popSize);
+        std::vector<uint32_t> parents;
+
+        bench.run("selection/tournament", {{"pop_size", popSize}}, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                doNotOptimize(ops.tournamentSelection(fitness));
+            }
+        });
+
+        // a whole generation of picks; per pick, it should not grow with popSize
+        const char* selections[] = { "tournament", "rank", "roulette", "sus" };
+        for (size_t s = 0; s < 4; ++s) {
+            GeneticOperators::Selection selection;
+            GeneticOperators::parseSelection(selections[s], selection);
+            ops.setSelection(selection);
+            bench.run(std::string("selection/select_parents/") + selections[s], {{"pop_size", popSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ops.selectParents(fitness, parents);
+                    doNotOptimize(parents.data());
+                }
+            });
+        }
+        ops.setSelection(GeneticOperators::TOURNAMENT);
+
+        for (size_t l = 0; l < s_lutSizes.size(); ++l) {
+            const size_t lutSize = s_lutSizes[l];
+            if (!bench.enabled("breed/crossover_mutation") && !bench.enabled("generation/next")) {
+                continue;
+            }
+
+            TConfigurationNode params("params");
+            SetNodeAttribute(params, "lut_size", lutSize);
+            MockRobot<DemoCtrl> robot(params);
+            Population population;
+            randPopulation(robot.controller, popSize, lutSize, population);
+            const GeneticOperators::RandGene randGene = [&](uint32_t, RandomStream& rng, uint8_t* gene) {
+                robot.controller.fillRandGene(gene, rng);
+            };
+            ops.selectParents(fitness, parents);
+
+            bench.run("breed/crossover_mutation", {{"pop_size", popSize}, {"lut_size", lutSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ops.breed(parents, population, randGene);
+                    population.swap();
+                }
+            });
+
+            // the same, with one thread per core (if the generation is large enough)
+            ops.setThreads(0);
+            bench.run("breed/crossover_mutation_threads", {{"pop_size", popSize}, {"lut_size", lutSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ops.breed(parents, population, randGene);
+                    population.swap();
+                }
+            });
+            ops.setThreads(1);
+
+            // what happens between two evaluations: selection, breeding and turnover
+            bench.run("generation/next", {{"pop_size", popSize}, {"lut_size", lutSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ops.selectParents(fitness, parents);
+                    ops.breed(parents, population, randGene);
+                    population.swap();
+                }
+            });
+        }
+    }
+}
+
+static void benchArchive(Bench& bench, CRandom::CRNG* rng, const QTemporaryDir& tmp)
+{
+    const uint32_t maxGenerations = 64;
+
+    for (size_t p = 0; p < s_popSizes.size(); ++p) {
+        for (size_t l = 0; l < s_lutSizes.size(); ++l) {
+            const size_t popSize = s_popSizes[p];
+            const size_t lutSize = s_lutSizes[l];
+            if (!bench.enabled("io/archive")) {
+                continue;
+            }
+
+            TConfigurationNode params("params");
+            SetNodeAttribute(params, "lut_size", lutSize);
+            MockRobot<DemoCtrl> robot(params);
+            Population population;
+            randPopulation(robot.controller, popSize, lutSize, population);
+            const std::vector<float> fitness = randFitness(rng, popSize);
+            const QString fileName = tmp.filePath(QString("archive_%1_%2.kga").arg(popSize).arg(lutSize));
+
+            // one generation per op; a new archive is started every 'maxGenerations'
+            ArchiveWriter writer;
+            uint32_t generation = maxGenerations;
+            bench.run("io/archive_write", {{"pop_size", popSize}, {"lut_size", lutSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    if (generation == maxGenerations) {
+                        if (!writer.open(fileName, robot.controller.geneDescriptor(), lutSize,
+                                         population.stride(), popSize, maxGenerations)) {
+                            qFatal("\n[FATAL] %s\n", qUtf8Printable(writer.errorString()));
+                        }
+                        generation = 0;
+                    }
+                    if (!writer.writeGeneration(generation++, fitness.data(), population.currentData())) {
+                        qFatal("\n[FATAL] %s\n", qUtf8Printable(writer.errorString()));
+                    }
+                }
+            });
+            if (generation == maxGenerations) {
+                // the write benchmark was filtered out
+                if (!writer.open(fileName, robot.controller.geneDescriptor(), lutSize,
+                                 population.stride(), popSize, maxGenerations)
+                        || !writer.writeGeneration(0, fitness.data(), population.currentData())) {
+                    qFatal("\n[FATAL] %s\n", qUtf8Printable(writer.errorString()));
+                }
+            }
+            writer.close();
+
+            // open the archive and load a generation into the population
+            bench.run("io/archive_read", {{"pop_size", popSize}, {"lut_size", lutSize}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    ArchiveReader reader;
+                    if (!reader.open(fileName)) {
+                        qFatal("\n[FATAL] %s\n", qUtf8Printable(reader.errorString()));
+                    }
+                    for (uint32_t kbId = 0; kbId < popSize; ++kbId) {
+                        population.next(kbId).copyFrom(reader.chromosome(0, kbId));
+                    }
+                    doNotOptimize(reader.fitness(0)[0]);
+                }
+            });
+        }
+    }
+}
+
+// write (and read back) a whole generation as text files, one per robot
+template <typename LF, typename G>
+static void benchText(Bench& bench, const std::string& name, const QTemporaryDir& tmp,
+                      Population& population, const Bench::Params& params)
+{
+    const std::string writeName = "io/text_write_" + name;
+    const std::string readName = "io/text_read_" + name;
+    if (!bench.enabled(writeName) && !bench.enabled(readName)) {
+        return;
+    }
+
+    QString dirName = QString::fromStdString(name);
+    for (size_t i = 0; i < params.size(); ++i) {
+        dirName += QString("_%1").arg((qint64) params[i].second);
+    }
+    QDir(tmp.path()).mkpath(dirName);
+
+    std::vector<QString> paths(population.size());
+    for (size_t kbId = 0; kbId < paths.size(); ++kbId) {
+        paths[kbId] = QString("%1/%2/kb_%3.dat").arg(tmp.path()).arg(dirName).arg((qint64) kbId);
+    }
+
+    QString error;
+    auto writeAll = [&]() {
+        for (size_t kbId = 0; kbId < paths.size(); ++kbId) {
+            if (!LF::writeChromosome(paths[kbId], population.current(kbId), error)) {
+                qFatal("\n[FATAL] %s\n", qUtf8Printable(error));
+            }
+        }
+    };
+    bench.run(writeName, params, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            writeAll();
+        }
+    });
+    if (!bench.enabled(writeName)) {
+        writeAll(); // the files are needed anyway
+    }
+
+    std::vector<G> genes;
+    bench.run(readName, params, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            for (size_t kbId = 0; kbId < paths.size(); ++kbId) {
+                if (!LF::readChromosome(paths[kbId], genes, error)) {
+                    qFatal("\n[FATAL] %s\n", qUtf8Printable(error));
+                }
+                population.next(kbId).copyFrom(Chromosome::fromGenes(genes).view());
+            }
+        }
+    });
+}
+
+static void benchTextFiles(Bench& bench, const QTemporaryDir& tmp)
+{
+    TConfigurationNode pdParams("params");
+    MockRobot<PDCtrl> pdRobot(pdParams);
+
+    for (size_t p = 0; p < s_popSizes.size(); ++p) {
+        const size_t popSize = s_popSizes[p];
+        for (size_t l = 0; l < s_lutSizes.size(); ++l) {
+            const size_t lutSize = s_lutSizes[l];
+            TConfigurationNode params("params");
+            SetNodeAttribute(params, "lut_size", lutSize);
+            MockRobot<DemoCtrl> robot(params);
+            Population population;
+            randPopulation(robot.controller, popSize, lutSize, population);
+            benchText<DemoLF, MotorSpeed>(bench, "demo", tmp, population,
+                                          {{"pop_size", popSize}, {"lut_size", lutSize}});
+        }
+
+        Population population;
+        randPopulation(pdRobot.controller, popSize, 1, population);
+        benchText<PDLF, uint8_t>(bench, "pd", tmp, population, {{"pop_size", popSize}});
+    }
+}
+
+// packets received by a robot; 'strategies' fills the messages with PD strategies
+static void randPackets(CRandom::CRNG* rng, size_t count, bool strategies,
+                        std::vector<message_t>& messages,
+                        CCI_KilobotCommunicationSensor::TPackets& packets)
+{
+    messages.resize(count);
+    packets.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        memset(&messages[i], 0, sizeof(message_t));
+        if (strategies) {
+            messages[i].data[0] = (uint8_t) rng->Uniform(CRange<UInt32>(0, 3));
+        }
+        // covers the whole range of the sensor, including out-of-range readings
+        const uint8_t d = (uint8_t) rng->Uniform(CRange<UInt32>(30, 110));
+        packets[i].Message = &messages[i];
+        packets[i].Distance.low_gain = d;
+        packets[i].Distance.high_gain = d;
+    }
+}
+
+// the control step must not touch the heap (it runs for every robot, every tick)
+template <typename C>
+static void checkAllocations(const std::string& name, MockRobot<C>& robot)
+{
+    robot.controller.ControlStep(); // warm-up
+    const uint64_t before = s_allocations.load();
+    for (int i = 0; i < ALLOC_CHECK_STEPS; ++i) {
+        robot.controller.ControlStep();
+    }
+    const uint64_t allocations = s_allocations.load() - before;
+    if (allocations > 0) {
+        std::cerr << "[ERROR] " << name << ": " << allocations << " heap allocations in "
+                  << ALLOC_CHECK_STEPS << " control steps" << std::endl;
+        s_allocationFree = false;
+    }
+}
+
+// every controller, LUT size and number of packets of the benchmarks
+static void checkControlSteps(CRandom::CRNG* rng)
+{
+    std::vector<message_t> messages;
+    CCI_KilobotCommunicationSensor::TPackets packets;
+
+    for (size_t k = 0; k < s_packetCounts.size(); ++k) {
+        const size_t count = s_packetCounts[k];
+
+        for (size_t l = 0; l < s_lutSizes.size(); ++l) {
+            TConfigurationNode params("params");
+            SetNodeAttribute(params, "lut_size", s_lutSizes[l]);
+            MockRobot<DemoCtrl> robot(params);
+            randPackets(rng, count, false, messages, packets);
+            robot.devices.commIn.setPackets(packets);
+            checkAllocations("control_step/demo", robot);
+        }
+
+        TConfigurationNode params("params");
+        MockRobot<PDCtrl> robot(params);
+        randPackets(rng, count, true, messages, packets);
+        robot.devices.commIn.setPackets(packets);
+        checkAllocations("control_step/pd", robot);
+    }
+}
+
+static void benchControlStep(Bench& bench, CRandom::CRNG* rng)
+{
+    std::vector<message_t> messages;
+    CCI_KilobotCommunicationSensor::TPackets packets;
+
+    for (size_t k = 0; k < s_packetCounts.size(); ++k) {
+        const size_t count = s_packetCounts[k];
+
+        for (size_t l = 0; l < s_lutSizes.size() && bench.enabled("control_step/demo"); ++l) {
+            const size_t lutSize = s_lutSizes[l];
+            TConfigurationNode params("params");
+            SetNodeAttribute(params, "lut_size", lutSize);
+            MockRobot<DemoCtrl> robot(params);
+            randPackets(rng, count, false, messages, packets);
+            robot.devices.commIn.setPackets(packets);
+
+            bench.run("control_step/demo", {{"lut_size", lutSize}, {"packets", count}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    robot.controller.ControlStep();
+                }
+                doNotOptimize(robot.controller.getPerformance());
+            });
+        }
+
+        if (bench.enabled("control_step/pd")) {
+            TConfigurationNode params("params");
+            MockRobot<PDCtrl> robot(params);
+            randPackets(rng, count, true, messages, packets);
+            robot.devices.commIn.setPackets(packets);
+
+            bench.run("control_step/pd", {{"packets", count}}, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    robot.controller.ControlStep();
+                }
+                doNotOptimize(robot.controller.getPerformance());
+            });
+        }
+    }
+}
+
+static void usage(const char* program)
+{
+    std::cerr << "usage: " << program
+              << " [--quick] [--check] [--filter <substring>] [--min-time <seconds>] [--out <file>]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    Bench bench;
+    bool quick = false;
+    bool checkOnly = false;
+    QString outFileName;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            quick = true;
+        } else if (arg == "--check") {
+            checkOnly = true;
+        } else if (arg == "--filter" && hasValue) {
+            bench.setFilter(argv[++i]);
+        } else if (arg == "--min-time" && hasValue) {
+            bench.setMinTime(atof(argv[++i]));
+        } else if (arg == "--out" && hasValue) {
+            outFileName = argv[++i];
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (quick) {
+        s_popSizes = {10, 100};
+        s_lutSizes = {22};
+        s_packetCounts = {0, 8};
+        bench.setMinTime(0.01);
+        bench.setRepetitions(3);
+    } else {
+        s_popSizes = {10, 100, 1000, 10000};
+        s_lutSizes = {22, 68};
+        s_packetCounts = {0, 4, 16, 64};
+    }
+
+    // the controllers take their default seed from this category
+    CRandom::CreateCategory("kilobotga", BENCH_SEED);
+    CRandom::CRNG* rng = CRandom::CreateRNG("kilobotga");
+
+    // a control step which allocates memory is a regression
+    checkControlSteps(rng);
+    if (checkOnly) {
+        return s_allocationFree ? 0 : 2;
+    }
+
+    QTemporaryDir tmp;
+    if (!tmp.isValid()) {
+        qFatal("\n[FATAL] Unable to create a temporary directory!\n");
+    }
+
+    benchOperators(bench, rng);
+    benchArchive(bench, rng, tmp);
+    benchTextFiles(bench, tmp);
+    benchRandom(bench, rng);
+    benchControlStep(bench, rng);
+
+    const QByteArray json = QJsonDocument(bench.toJson()).toJson();
+    if (outFileName.isEmpty()) {
+        std::cout << json.constData() << std::endl;
+    } else {
+        QFile out(outFileName);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(json) != json.size()) {
+            std::cerr << "Unable to write in " << qUtf8Printable(outFileName) << std::endl;
+            return 1;
+        }
+    }
+
+    return s_allocationFree ? 0 : 2;
+}
@@ -19,8 +19,7 @@
 #include "abstractga_ctrl.h"
 
 AbstractGACtrl::AbstractGACtrl()
-    : m_pcRNG(CRandom::CreateRNG("kilobotga"))
-    , m_pcMotors(NULL)
+    : m_pcMotors(NULL)
     , m_pcSensorOut(NULL)
     , m_pcSensorIn(NULL)
     , m_kMaxDistance(100)
@@ -31,6 +30,10 @@ AbstractGACtrl::AbstractGACtrl()
     , m_iCurrentTick(0)
     , m_iNextMotionTick(0)
     , m_currentMotion(STOP)
+    , m_fLeftSpeed(0)
+    , m_fRightSpeed(0)
+    , m_bSpeedSet(false)
+    , m_bColorSet(false)
 {
 }
 
@@ -40,11 +43,39 @@ void AbstractGACtrl::Init(TConfigurationNode& t_node)
     m_pcSensorOut = GetActuator<CCI_KilobotCommunicationActuator>("kilobot_communication");
     m_pcSensorIn = GetSensor<CCI_KilobotCommunicationSensor>("kilobot_communication");
     m_pcLED = GetActuator<CCI_LEDsActuator>("leds");
+
+    // until the loop function says otherwise, the stream is given by the
+    // seed of the experiment and the id of the robot
+    const UInt32 seed = CRandom::ExistsCategory("kilobotga") ? CRandom::GetSeedOf("kilobotga") : 0;
+    m_rng.setKey(seed, idHash(GetId()));
+}
+
+UInt32 AbstractGACtrl::idHash(const std::string& id)
+{
+    // FNV-1a
+    UInt32 hash = 2166136261u;
+    for (size_t i = 0; i < id.size(); ++i) {
+        hash = (hash ^ (uint8_t) id[i]) * 16777619u;
+    }
+    return hash;
 }
 
 void AbstractGACtrl::Reset()
 {
+    // each evaluation starts from scratch
     m_fPerformance = 0.f;
+    m_iCurrentTick = 0;
+    m_iNextMotionTick = 0;
+    m_currentMotion = STOP;
+    // the simulator resets the devices too
+    m_bSpeedSet = false;
+    m_bColorSet = false;
+}
+
+void AbstractGACtrl::setSeed(UInt32 seed, UInt32 robot, UInt32 generation, UInt32 trial)
+{
+    m_rng.setKey(seed, robot);
+    m_rng.setCounter(generation, trial);
 }
 
 void AbstractGACtrl::setMotion(Motion motion)
@@ -68,8 +99,8 @@ void AbstractGACtrl::setMotion(Motion motion)
         }
         case RAND_SPEEDS: {
             const CRange<Real> speedRange(0, 1);
-            left = m_pcRNG->Uniform(speedRange);
-            right = m_pcRNG->Uniform(speedRange);
+            left = m_rng.uniform(speedRange);
+            right = m_rng.uniform(speedRange);
             break;
         }
         case STOP:
@@ -78,7 +109,28 @@ void AbstractGACtrl::setMotion(Motion motion)
     }
 
     m_currentMotion = motion;
-    m_pcMotors->SetLinearVelocity(left * SPEED_SCALE, right * SPEED_SCALE);
+    setSpeed(left * SPEED_SCALE, right * SPEED_SCALE);
+}
+
+void AbstractGACtrl::setSpeed(Real left, Real right)
+{
+    if (m_bSpeedSet && left == m_fLeftSpeed && right == m_fRightSpeed) {
+        return;
+    }
+    m_bSpeedSet = true;
+    m_fLeftSpeed = left;
+    m_fRightSpeed = right;
+    m_pcMotors->SetLinearVelocity(left, right);
+}
+
+void AbstractGACtrl::setColor(const CColor& color)
+{
+    if (m_bColorSet && color == m_ledColor) {
+        return;
+    }
+    m_bColorSet = true;
+    m_ledColor = color;
+    m_pcLED->SetAllColors(color);
 }
 
 void AbstractGACtrl::randWalk()
@@ -90,10 +142,10 @@ void AbstractGACtrl::randWalk()
 
     if (m_currentMotion == FORWARD) {
         // flip coin: left or right?
-        setMotion(m_pcRNG->Bernoulli() ? TURN_LEFT : TURN_RIGHT);
-        m_iNextMotionTick = m_iCurrentTick + m_pcRNG->Uniform(CRange<UInt32>(1, m_kMaxTurningTicks));
+        setMotion(m_rng.bernoulli() ? TURN_LEFT : TURN_RIGHT);
+        m_iNextMotionTick = m_iCurrentTick + m_rng.uniform(CRange<UInt32>(1, m_kMaxTurningTicks));
     } else {
         setMotion(FORWARD);
-        m_iNextMotionTick = m_iCurrentTick + m_pcRNG->Uniform(CRange<UInt32>(1, m_kMaxForwardTicks));
+        m_iNextMotionTick = m_iCurrentTick + m_rng.uniform(CRange<UInt32>(1, m_kMaxForwardTicks));
     }
 }
@@ -26,7 +26,8 @@
 #include <argos3/plugins/robots/kilobot/control_interface/ci_kilobot_communication_sensor.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
 
-#include <QVariant>
+#include "chromosome.h"
+#include "random_stream.h"
 
 using namespace argos;
 
@@ -39,12 +40,16 @@ using namespace argos;
 
 // Motor speed [0, 1)
 struct MotorSpeed {
-   Real left;
-   Real right;
+   float left;
+   float right;
 };
-Q_DECLARE_METATYPE(MotorSpeed)
 
-typedef std::vector<QVariant> Chromosome;
+template <> struct GeneTraits<MotorSpeed> {
+    static GeneDescriptor descriptor() {
+        GeneDescriptor d = { GeneDescriptor::FLOAT32, 2 };
+        return d;
+    }
+};
 
 /**
  * @brief The AbstractGACtrl class
@@ -57,21 +62,36 @@ public:
     AbstractGACtrl();
     virtual ~AbstractGACtrl() {}
 
+    // bind the controller to the given genes (no copy is made);
+    // the genes are owned by the caller and must outlive this binding.
     // return false if chromosome is not suitable
-    virtual bool setChromosome(Chromosome chromosome) = 0;
+    virtual bool setChromosome(const ChromosomeView& chromosome) = 0;
+
+    // size of each gene (in bytes)
+    virtual size_t geneSize() const = 0;
+
+    // layout of each gene
+    virtual GeneDescriptor geneDescriptor() const = 0;
 
-    // generate a random gene
-    virtual QVariant randGene() const = 0;
+    // write a random gene at the given address, drawn from the given stream;
+    // it only reads the parameters of the controller, so it is thread-safe
+    virtual void fillRandGene(uint8_t* gene, RandomStream& rng) const = 0;
+    // same, drawn from the stream of this robot
+    inline void fillRandGene(uint8_t* gene) const { fillRandGene(gene, m_rng); }
 
-    inline const Chromosome& getChromosome() const { return m_chromosome; }
+    inline const ChromosomeView& getChromosome() const { return m_chromosome; }
     inline const float& getPerformance() const { return m_fPerformance; }
 
+    // move to the random stream of a robot in the given generation and
+    // trial (the same arguments always give the same numbers)
+    void setSeed(UInt32 seed, UInt32 robot, UInt32 generation, UInt32 trial = 0);
+
     // CCI_Controler stuff
     virtual void Init(TConfigurationNode& t_node);
     virtual void Reset();
 
 protected:
-    CRandom::CRNG*  m_pcRNG; // random number generator
+    mutable RandomStream m_rng; // random numbers of this robot
 
     // actuators and sensors
     CCI_DifferentialSteeringActuator* m_pcMotors;
@@ -87,7 +107,8 @@ protected:
 
     // genetic algorithm stuff
     float m_fPerformance; // global performance of this kilobot
-    Chromosome m_chromosome;
+    ChromosomeView m_chromosome; // genes in use (usually owned by the loop function)
+    Chromosome m_ownChromosome;  // random genes used until the controller is bound
 
     enum Motion {
         STOP,
@@ -101,10 +122,53 @@ protected:
     uint32_t m_iNextMotionTick;
     Motion m_currentMotion;
 
+    // last values written in the devices
+    Real m_fLeftSpeed;
+    Real m_fRightSpeed;
+    CColor m_ledColor;
+    bool m_bSpeedSet; // false until the first write after a reset
+    bool m_bColorSet;
+
     void setMotion(Motion motion);
 
+    // the robot part of the default key
+    static UInt32 idHash(const std::string& id);
+
+    // the devices are only written when the value changes
+    void setSpeed(Real left, Real right);
+    void setColor(const CColor& color);
+
     void randWalk();
 
 };
 
+/**
+ * @brief The TypedGACtrl class
+ * Base class for controllers whose chromosome is made of genes of type G.
+ * @author KilobotGA contributors
+ */
+template <typename G>
+class TypedGACtrl : public AbstractGACtrl
+{
+
+public:
+    typedef G Gene;
+
+    TypedGACtrl() : AbstractGACtrl() {}
+    virtual ~TypedGACtrl() {}
+
+    // generate a random gene (thread-safe)
+    virtual G randGene(RandomStream& rng) const = 0;
+
+    virtual size_t geneSize() const { return sizeof(G); }
+    virtual GeneDescriptor geneDescriptor() const { return GeneTraits<G>::descriptor(); }
+    using AbstractGACtrl::fillRandGene;
+    virtual void fillRandGene(uint8_t* gene, RandomStream& rng) const {
+        *reinterpret_cast<G*>(gene) = randGene(rng);
+    }
+
+protected:
+    inline const G& gene(size_t i) const { return m_chromosome.gene<G>(i); }
+};
+
 #endif // ABSTRACTGA_CTRL_H
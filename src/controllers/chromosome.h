@@ -0,0 +1,173 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHROMOSOME_H
+#define CHROMOSOME_H
+
+#include <cassert>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief The GeneDescriptor struct
+ * Describes the layout of a gene, i.e., 'count' scalars of the same type.
+ * It allows storing and loading genes without knowing their C++ type.
+ */
+struct GeneDescriptor {
+    enum Scalar {
+        UINT8 = 1,
+        FLOAT32 = 2
+    };
+    uint32_t scalar;
+    uint32_t count;
+
+    inline size_t scalarSize() const { return scalar == FLOAT32 ? 4 : 1; }
+    inline size_t geneSize() const { return scalarSize() * count; }
+    inline bool operator==(const GeneDescriptor& o) const {
+        return scalar == o.scalar && count == o.count;
+    }
+};
+
+// each gene type must provide a specialization of this template
+template <typename G> struct GeneTraits;
+
+template <> struct GeneTraits<uint8_t> {
+    static GeneDescriptor descriptor() {
+        GeneDescriptor d = { GeneDescriptor::UINT8, 1 };
+        return d;
+    }
+};
+
+/**
+ * @brief The ChromosomeView class
+ * A non-owning view of a fixed-length sequence of genes stored contiguously
+ * in memory. All genes have the same size (in bytes), which is defined by
+ * the controller; use gene<G>(i) to get a typed access to the i-th gene.
+ * Copying a view never copies the genes.
+ * @author KilobotGA contributors
+ */
+class ChromosomeView
+{
+
+public:
+    ChromosomeView() : m_data(NULL), m_iGeneSize(0), m_iLength(0) {}
+    ChromosomeView(uint8_t* data, size_t geneSize, size_t length)
+        : m_data(data), m_iGeneSize(geneSize), m_iLength(length) {}
+
+    inline bool isNull() const { return m_data == NULL; }
+    inline size_t size() const { return m_iLength; }
+    inline size_t geneSize() const { return m_iGeneSize; }
+    inline size_t byteSize() const { return m_iGeneSize * m_iLength; }
+
+    inline uint8_t* data() { return m_data; }
+    inline const uint8_t* data() const { return m_data; }
+
+    // raw address of the i-th gene
+    inline uint8_t* at(size_t i) { return m_data + i * m_iGeneSize; }
+    inline const uint8_t* at(size_t i) const { return m_data + i * m_iGeneSize; }
+
+    // typed access to the i-th gene
+    template <typename G>
+    inline G& gene(size_t i) {
+        assert(sizeof(G) == m_iGeneSize);
+        return *reinterpret_cast<G*>(at(i));
+    }
+    template <typename G>
+    inline const G& gene(size_t i) const {
+        assert(sizeof(G) == m_iGeneSize);
+        return *reinterpret_cast<const G*>(at(i));
+    }
+
+    // copy the i-th gene of another chromosome (same layout) into this one
+    inline void copyGene(size_t i, const ChromosomeView& other) {
+        memcpy(at(i), other.at(i), m_iGeneSize);
+    }
+
+    // copy all genes of another chromosome (same layout) into this one
+    inline void copyFrom(const ChromosomeView& other) {
+        assert(sameLayout(other));
+        memcpy(m_data, other.m_data, byteSize());
+    }
+
+    inline bool sameLayout(const ChromosomeView& other) const {
+        return m_iGeneSize == other.m_iGeneSize && m_iLength == other.m_iLength;
+    }
+
+private:
+    uint8_t* m_data;
+    size_t m_iGeneSize; // in bytes
+    size_t m_iLength;   // number of genes
+};
+
+/**
+ * @brief The Chromosome class
+ * A chromosome which owns its genes. It is used when the genes do not live
+ * in a population buffer, e.g., the random genes of a standalone controller
+ * or the genes read from a file.
+ * @author KilobotGA contributors
+ */
+class Chromosome
+{
+
+public:
+    Chromosome() : m_iGeneSize(0), m_iLength(0) {}
+    Chromosome(size_t geneSize, size_t length)
+        : m_iGeneSize(geneSize)
+        , m_iLength(length)
+        , m_data(geneSize * length, 0) {}
+
+    // build a chromosome from a list of typed genes
+    template <typename G>
+    static Chromosome fromGenes(const std::vector<G>& genes)
+    {
+        Chromosome c(sizeof(G), genes.size());
+        if (!genes.empty()) {
+            memcpy(c.m_data.data(), &genes[0], c.m_data.size());
+        }
+        return c;
+    }
+
+    inline size_t size() const { return m_iLength; }
+    inline size_t geneSize() const { return m_iGeneSize; }
+
+    // the buffer is only reallocated when it grows
+    inline void resize(size_t geneSize, size_t length) {
+        m_iGeneSize = geneSize;
+        m_iLength = length;
+        m_data.resize(geneSize * length);
+    }
+
+    // the view is invalidated by resize()
+    inline ChromosomeView view() {
+        return ChromosomeView(m_data.data(), m_iGeneSize, m_iLength);
+    }
+    inline const ChromosomeView view() const {
+        return ChromosomeView(const_cast<uint8_t*>(m_data.data()), m_iGeneSize, m_iLength);
+    }
+
+    template <typename G>
+    inline G& gene(size_t i) { return view().gene<G>(i); }
+
+private:
+    size_t m_iGeneSize; // in bytes
+    size_t m_iLength;   // number of genes
+    std::vector<uint8_t> m_data;
+};
+
+#endif // CHROMOSOME_H
@@ -17,19 +17,25 @@
  */
 
 #include "demo_ctrl.h"
+#include "profiler.h"
 
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/logging/argos_log.h>
 
 #include <QString>
 
+#include <map>
+#include <mutex>
+
 // parameters of our fitness function
 #define ALPHA 3 // begning of the long tail
 #define MAX_LOCAL_PERFORMANCE 20 // max score received in one interaction
 
 DemoCtrl::DemoCtrl()
-    : AbstractGACtrl()
+    : TypedGACtrl<MotorSpeed>()
     , m_iLUTSize(68)
+    , m_pcSensorLUT(NULL)
+    , m_pfPerformance(NULL)
 {
 }
 
@@ -44,59 +50,62 @@ void DemoCtrl::Init(TConfigurationNode& t_node)
                << "). Should be a integer greater than 2." << std::endl;
     }
 
-    m_lutDistance.reserve(m_iLUTSize);
-    m_chromosome.reserve(m_iLUTSize);
+    initLUT();
 
     Reset();
 }
 
 void DemoCtrl::Reset()
 {
-    initLUT();
-    m_fPerformance = 0.f;
+    // the chromosome is not touched here; during the evolution,
+    // the loop function binds the genes of each generation
+    AbstractGACtrl::Reset();
 }
 
 void DemoCtrl::ControlStep()
 {
+    KGA_PROFILE(PROFILE_CONTROL_STEP);
+
     // send an empty message
     m_pcSensorOut->SetMessage(NULL);
 
-    // read messages
-    CCI_KilobotCommunicationSensor::TPackets in = m_pcSensorIn->GetPackets();
+    // read messages (no copy)
+    const CCI_KilobotCommunicationSensor::TPackets& in = m_pcSensorIn->GetPackets();
 
     // Handling signals received
     // if received more than 1 message, take the average distance
     // otherwise, use the max+1 distance (no-signal)
     uint8_t distance = 0;
     if (in.size()) {
+        uint32_t sum = 0;
         for (uint32_t i = 0; i < in.size(); ++i) {
             uint8_t d = in[i].Distance.high_gain;
-            m_fPerformance += calcPerformance(getLUTIndex(d)); // update performance
-            distance += d;
+            m_fPerformance += m_pfPerformance[d]; // update performance
+            sum += d;
         }
-        distance /= in.size();
+        distance = sum / in.size();
     } else { // no message was received
         distance = m_kMaxDistance + 1;
     }
 
     // update speed
-    const MotorSpeed m = m_chromosome[getLUTIndex(distance)].value<MotorSpeed>();
-    m_pcMotors->SetLinearVelocity(m.left * SPEED_SCALE, m.right * SPEED_SCALE);
+    const MotorSpeed& m = gene(getLUTIndex(distance));
+    setSpeed(m.left * SPEED_SCALE, m.right * SPEED_SCALE);
 }
 
-QVariant DemoCtrl::randGene() const
+MotorSpeed DemoCtrl::randGene(RandomStream& rng) const
 {
     const CRange<Real> speedRange(0, 1);
     MotorSpeed m;
-    m.left = QString::number(m_pcRNG->Uniform(speedRange),'g', SPEED_PRECISION).toDouble();
-    m.right = QString::number(m_pcRNG->Uniform(speedRange), 'g', SPEED_PRECISION).toDouble();
-    return QVariant::fromValue(m);
+    m.left = (float) rng.uniform(speedRange);
+    m.right = (float) rng.uniform(speedRange);
+    return m;
 }
 
-bool DemoCtrl::setChromosome(Chromosome chromosome)
+bool DemoCtrl::setChromosome(const ChromosomeView& chromosome)
 {
     // check for lut size. Must be equal to what we have in the .argos script
-    if (chromosome.size() != m_iLUTSize) {
+    if (chromosome.size() != m_iLUTSize || chromosome.geneSize() != sizeof(MotorSpeed)) {
         qFatal("\n[FATAL] Acconding to the XML file, the LUT size should be %ld", m_iLUTSize);
         return false;
     }
@@ -106,36 +115,40 @@ bool DemoCtrl::setChromosome(Chromosome chromosome)
 
 void DemoCtrl::initLUT()
 {
-    m_lutDistance.clear();
-    m_chromosome.clear();
-
     // first and last elements must hold the decision for MIN and MAX distance
     // i.e., [34, ... , no-signal]
-    const int distInterval = round((m_kMaxDistance - m_kMinDistance) / (double)(m_iLUTSize - 2.0));
-    int distance = m_kMinDistance;
+    m_pcSensorLUT = SensorLUT::linear(m_kMinDistance, m_kMaxDistance, m_iLUTSize);
+    m_pfPerformance = performanceTable(m_pcSensorLUT);
 
+    m_ownChromosome.resize(sizeof(MotorSpeed), m_iLUTSize);
     for (uint32_t i = 0; i < m_iLUTSize; ++i) {
-        m_chromosome.push_back(randGene());
-        m_lutDistance.push_back(distance);
-        distance += distInterval;
+        m_ownChromosome.gene<MotorSpeed>(i) = randGene(m_rng);
     }
-}
 
-size_t DemoCtrl::getLUTIndex(uint8_t distance) const
-{
-    if (distance <= m_kMaxDistance) {
-        for (size_t idx = 0; idx < m_lutDistance.size(); ++idx) {
-            if (distance < m_lutDistance[idx])
-                return idx;
-        }
-    }
-    return m_lutDistance.size() - 1; // use last as default
+    setChromosome(m_ownChromosome.view());
 }
 
-float DemoCtrl::calcPerformance(uint8_t distance) const
+float DemoCtrl::calcPerformance(uint8_t distance)
 {
     float x = distance + 1.f; // distance might be 0, so let's sum 1
     return MAX_LOCAL_PERFORMANCE * pow(x, -ALPHA);
 }
 
+const float* DemoCtrl::performanceTable(const SensorLUT* lut)
+{
+    static std::mutex mutex;
+    static std::map<const SensorLUT*, std::vector<float> > tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<float>& table = tables[lut];
+    if (table.empty()) {
+        // the performance is given by the lut index of the distance
+        table.resize(256);
+        for (int d = 0; d < 256; ++d) {
+            table[d] = calcPerformance(lut->index(d));
+        }
+    }
+    return table.data();
+}
+
 REGISTER_CONTROLLER(DemoCtrl, "kilobot_demo_controller")
@@ -20,12 +20,13 @@
 #define DEMO_CTRL_H
 
 #include "abstractga_ctrl.h"
+#include "sensor_lut.h"
 
 /**
  * @brief The DemoCtrl class
  * @author Marcos Cardinot <mcardinot@gmail.com>
  */
-class DemoCtrl : public AbstractGACtrl
+class DemoCtrl : public TypedGACtrl<MotorSpeed>
 {
 
 public:
@@ -33,10 +34,10 @@ public:
     virtual ~DemoCtrl() {}
 
     // generate a random gene (motor speed)
-    virtual QVariant randGene() const;
+    virtual MotorSpeed randGene(RandomStream& rng) const;
 
     // set chromosome (vector of motor speeds)
-    virtual bool setChromosome(Chromosome chromosome);
+    virtual bool setChromosome(const ChromosomeView& chromosome);
 
     // CCI_Controller stuff
     virtual void Init(TConfigurationNode& t_node);
@@ -45,17 +46,21 @@ public:
 
 private:
      size_t m_iLUTSize; // lookup table size; it'll define the chromossome size
-     std::vector<uint8_t> m_lutDistance; // range distances for each gene
+     const SensorLUT* m_pcSensorLUT; // distance (in mm) -> gene index (shared)
+     const float* m_pfPerformance;   // distance (in mm) -> local performance (shared)
 
-     // initialize our lookup tables with random values
+     // initialize our lookup tables (own chromosome gets random values)
      void initLUT();
 
      // get a lut index from a distance (in mm)
-     size_t getLUTIndex(uint8_t distance) const;
+     inline size_t getLUTIndex(uint8_t distance) const { return m_pcSensorLUT->index(distance); }
 
      // calculate the local performance
      // power-law: a*(x+1)^b.
-     float calcPerformance(uint8_t distance) const;
+     static float calcPerformance(uint8_t distance);
+
+     // local performance for each distance (one table per lookup table)
+     static const float* performanceTable(const SensorLUT* lut);
 };
 
 #endif // DEMO_CTRL_H
@@ -0,0 +1,89 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOCK_DEVICES_H
+#define MOCK_DEVICES_H
+
+#include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
+#include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
+#include <argos3/plugins/robots/kilobot/control_interface/ci_kilobot_communication_actuator.h>
+#include <argos3/plugins/robots/kilobot/control_interface/ci_kilobot_communication_sensor.h>
+
+using namespace argos;
+
+/*
+ * Sensors and actuators which only keep the last command (or the given
+ * readings), so the control step of a controller can run without ARGoS
+ * (e.g., in the benchmarks or in the kinematic surrogate).
+ * Controllers look them up by the names used in the .argos files.
+ */
+
+class MockMotors : public CCI_DifferentialSteeringActuator
+{
+public:
+    MockMotors() : m_fLeft(0), m_fRight(0) {}
+    virtual void SetLinearVelocity(Real left, Real right) { m_fLeft = left; m_fRight = right; }
+    Real m_fLeft;
+    Real m_fRight;
+};
+
+class MockLEDs : public CCI_LEDsActuator
+{
+public:
+    virtual void SetSingleColor(UInt32 led, const CColor& color) { m_color = color; }
+    virtual void SetAllColors(const CColor& color) { m_color = color; }
+    CColor m_color;
+};
+
+class MockCommActuator : public CCI_KilobotCommunicationActuator
+{
+public:
+    MockCommActuator() : m_ptLast(NULL) {}
+    virtual void SetMessage(message_t* message = NULL) { m_ptLast = message; }
+    message_t* m_ptLast;
+};
+
+class MockCommSensor : public CCI_KilobotCommunicationSensor
+{
+public:
+    // packets returned by GetPackets() from now on
+    inline void setPackets(const TPackets& packets) { m_tPackets = packets; }
+    // direct access, e.g., to refill the packets without reallocating
+    inline TPackets& packets() { return m_tPackets; }
+};
+
+/**
+ * @brief The MockDevices struct
+ * The devices of a kilobot; attach() registers them in a controller.
+ * They must outlive the controller.
+ */
+struct MockDevices {
+    MockMotors motors;
+    MockLEDs leds;
+    MockCommActuator commOut;
+    MockCommSensor commIn;
+
+    inline void attach(CCI_Controller& controller) {
+        controller.AddActuator("differential_steering", &motors);
+        controller.AddActuator("kilobot_communication", &commOut);
+        controller.AddActuator("leds", &leds);
+        controller.AddSensor("kilobot_communication", &commIn);
+    }
+};
+
+#endif // MOCK_DEVICES_H
@@ -0,0 +1,83 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "payoff.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+static std::mutex s_mutex;
+static std::vector<std::unique_ptr<PayoffTable> > s_tables;
+
+PayoffTable::PayoffTable(const PayoffMatrix& matrix)
+    : m_matrix(matrix)
+{
+    memset(m_rows, 0, sizeof(m_rows));
+    for (int a = 0; a < NUM_STRATEGIES; ++a) {
+        for (int b = 0; b < NUM_STRATEGIES; ++b) {
+            m_rows[a][b] = matrix.v[a][b];
+        }
+    }
+}
+
+const PayoffTable* PayoffTable::get(const PayoffMatrix& matrix)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (size_t i = 0; i < s_tables.size(); ++i) {
+        if (memcmp(&s_tables[i]->m_matrix, &matrix, sizeof(PayoffMatrix)) == 0) {
+            return s_tables[i].get();
+        }
+    }
+    s_tables.push_back(std::unique_ptr<PayoffTable>(new PayoffTable(matrix)));
+    return s_tables.back().get();
+}
+
+bool PayoffTable::matrixByName(const std::string& name, PayoffMatrix& matrix)
+{
+    if (name == "pd") {
+        matrix = Games::PRISONERS_DILEMMA;
+    } else if (name == "snowdrift") {
+        matrix = Games::SNOWDRIFT;
+    } else if (name == "staghunt") {
+        matrix = Games::STAG_HUNT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool PayoffTable::parseMatrix(const std::string& values, PayoffMatrix& matrix)
+{
+    std::istringstream in(values);
+    for (int i = 0; i < NUM_STRATEGIES * NUM_STRATEGIES; ++i) {
+        if (i > 0) {
+            char comma = 0;
+            if (!(in >> comma) || comma != ',') {
+                return false;
+            }
+        }
+        if (!(in >> matrix.v[i / NUM_STRATEGIES][i % NUM_STRATEGIES])) {
+            return false;
+        }
+    }
+    char extra;
+    return !(in >> extra);
+}
@@ -0,0 +1,99 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PAYOFF_H
+#define PAYOFF_H
+
+#include <argos3/plugins/robots/kilobot/control_interface/ci_kilobot_communication_sensor.h>
+
+#include <string>
+
+using namespace argos;
+
+// pure strategies: 0 (cooperate), 1 (defect) or 2 (abstain)
+#define NUM_STRATEGIES 3
+
+/**
+ * @brief The PayoffMatrix struct
+ * v[a][b] is the payoff of a player using strategy 'a' against 'b'.
+ */
+struct PayoffMatrix {
+    float v[NUM_STRATEGIES][NUM_STRATEGIES];
+};
+
+// Social dilemmas with abstention: R (CC), S (CD), T (DC), P (DD).
+// Whoever meets an abstainer gets the loner's payoff, i.e., (P+R)/2.
+namespace Games {
+    // T > R > P > S
+    constexpr PayoffMatrix PRISONERS_DILEMMA = {{ { 3.f, 0.f, 2.f },
+                                                  { 5.f, 1.f, 2.f },
+                                                  { 2.f, 2.f, 2.f } }};
+    // T > R > S > P
+    constexpr PayoffMatrix SNOWDRIFT = {{ { 3.f, 2.f, 1.5f },
+                                          { 4.f, 0.f, 1.5f },
+                                          { 1.5f, 1.5f, 1.5f } }};
+    // R > T >= P > S
+    constexpr PayoffMatrix STAG_HUNT = {{ { 4.f, 0.f, 3.f },
+                                          { 3.f, 2.f, 3.f },
+                                          { 3.f, 3.f, 3.f } }};
+}
+
+/**
+ * @brief The PayoffTable class
+ * Branch-free payoff lookup. For each strategy, it holds a row with the
+ * payoff against every possible byte received in a message (invalid
+ * strategies are worth 0), so scoring a packet is a single load.
+ * Tables are immutable and shared by all controllers playing the same game.
+ * @author KilobotGA contributors
+ */
+class PayoffTable
+{
+
+public:
+    // get the shared table of a game (created on first use; thread-safe)
+    static const PayoffTable* get(const PayoffMatrix& matrix);
+
+    // 'pd', 'snowdrift' or 'staghunt'
+    static bool matrixByName(const std::string& name, PayoffMatrix& matrix);
+    // nine comma-separated values, row by row, e.g., "3,0,2,5,1,2,2,2,2"
+    static bool parseMatrix(const std::string& values, PayoffMatrix& matrix);
+
+    // payoffs of 'strategy' against every possible byte
+    inline const float* row(uint8_t strategy) const {
+        return m_rows[strategy < NUM_STRATEGIES ? strategy : NUM_STRATEGIES];
+    }
+
+    // total payoff of a player (row) against all senders of a batch of packets
+    static inline float score(const float* row, const CCI_KilobotCommunicationSensor::TPackets& packets) {
+        float sum = 0.f;
+        for (size_t i = 0; i < packets.size(); ++i) {
+            sum += row[packets[i].Message->data[0]];
+        }
+        return sum;
+    }
+
+    inline const PayoffMatrix& matrix() const { return m_matrix; }
+
+private:
+    PayoffMatrix m_matrix;
+    float m_rows[NUM_STRATEGIES + 1][256]; // last row: invalid strategy
+
+    explicit PayoffTable(const PayoffMatrix& matrix);
+};
+
+#endif // PAYOFF_H
@@ -17,6 +17,7 @@
  */
 
 #include "pd_ctrl.h"
+#include "profiler.h"
 
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/logging/argos_log.h>
@@ -24,7 +25,10 @@
 #include <QString>
 
 PDCtrl::PDCtrl()
-    : AbstractGACtrl()
+    : TypedGACtrl<uint8_t>()
+    , m_curStrategy(0)
+    , m_pcPayoff(PayoffTable::get(Games::PRISONERS_DILEMMA))
+    , m_pfPayoffRow(m_pcPayoff->row(0))
 {
     Reset();
 }
@@ -32,60 +36,77 @@ PDCtrl::PDCtrl()
 void PDCtrl::Init(TConfigurationNode &t_node)
 {
     AbstractGACtrl::Init(t_node);
+
+    // parse the configuration file
+    std::string game, payoff;
+    GetNodeAttributeOrDefault(t_node, "game", game, std::string("pd"));
+    GetNodeAttributeOrDefault(t_node, "payoff", payoff, std::string());
+    PayoffMatrix matrix;
+    if (!payoff.empty()) {
+        if (!PayoffTable::parseMatrix(payoff, matrix)) {
+            qFatal("\n[FATAL] Invalid payoff matrix '%s'. Expected 9 comma-separated values.",
+                   payoff.c_str());
+        }
+    } else if (!PayoffTable::matrixByName(game, matrix)) {
+        qFatal("\n[FATAL] Unknown game '%s'. Expected 'pd', 'snowdrift' or 'staghunt'.",
+               game.c_str());
+    }
+    m_pcPayoff = PayoffTable::get(matrix);
+
+    // pure game strategy,
+    // i.e., 0 (cooperate), 1 (defect) or 2 (abstain)
+    m_ownChromosome.resize(sizeof(uint8_t), 1);
+    m_ownChromosome.gene<uint8_t>(0) = randGene(m_rng);
+    setChromosome(m_ownChromosome.view());
+
     Reset();
 }
 
 void PDCtrl::Reset()
 {
+    // the chromosome is not touched here; during the evolution,
+    // the loop function binds the genes of each generation
     AbstractGACtrl::Reset();
-
-    // pure game strategy,
-    // i.e., 0 (cooperate), 1 (defect) or 2 (abstain)
-    Chromosome chromosome;
-    chromosome.reserve(1);
-    chromosome.push_back(randGene());
-    setChromosome(chromosome);
 }
 
 void PDCtrl::ControlStep()
 {
+    KGA_PROFILE(PROFILE_CONTROL_STEP);
+
     // send message with my strategy
     m_pcSensorOut->SetMessage(&m_message);
 
-    // read messages
-    CCI_KilobotCommunicationSensor::TPackets in = m_pcSensorIn->GetPackets();
+    // read messages (no copy)
+    const CCI_KilobotCommunicationSensor::TPackets& in = m_pcSensorIn->GetPackets();
 
     // for each signal received, accumulate the payoff
     // obtained through the game interaction
-    for (uint32_t i = 0; i < in.size(); ++i) {
-        uint8_t strategyB = in[i].Message->data[0];
-        m_fPerformance += calcPerformance(m_curStrategy, strategyB); // update performance
-    }
+    m_fPerformance += PayoffTable::score(m_pfPayoffRow, in);
 
     // update speed
     randWalk();
 
     // led color
-    m_pcLED->SetAllColors(m_curColor);
+    setColor(m_curColor);
 }
 
-QVariant PDCtrl::randGene() const
+uint8_t PDCtrl::randGene(RandomStream& rng) const
 {
     // pure strategy: 0 (C), 1 (D) or 2 (A)
-    int strategy = m_pcRNG->Uniform(CRange<UInt32>(0, 3));
-    return QVariant::fromValue(strategy);
+    return (uint8_t) rng.uniform(CRange<UInt32>(0, 3));
 }
 
-bool PDCtrl::setChromosome(Chromosome chromosome)
+bool PDCtrl::setChromosome(const ChromosomeView& chromosome)
 {
     // chromosome holds one gene, which is the pure game strategy
-    if (chromosome.size() != 1) {
+    if (chromosome.size() != 1 || chromosome.geneSize() != sizeof(uint8_t)) {
         qFatal("\n[FATAL] Chromosome should have only one gene! (%ld)", chromosome.size());
         return false;
     }
 
     m_chromosome = chromosome;
-    m_curStrategy = (uint8_t) chromosome[0].toInt();
+    m_curStrategy = gene(0);
+    m_pfPayoffRow = m_pcPayoff->row(m_curStrategy);
     m_message.data[0] = m_curStrategy;
 
     switch (m_curStrategy) {
@@ -105,25 +126,4 @@ bool PDCtrl::setChromosome(Chromosome chromosome)
     return true;
 }
 
-float PDCtrl::calcPerformance(uint8_t sA, uint8_t sB)
-{
-    if (sA == 2 || sB == 2) { // abstain
-        return 2;
-    }
-
-    switch (sA*2+sB) {
-    case 0: // CC
-        return 3;
-    case 1: // CD
-        return 0;
-    case 2: // DC
-        return 5;
-    case 3: // DD
-        return 1;
-    default:
-        qFatal("\n[FATAL] wrong inputs in calcPerformance(%d, %d)", sA, sB);
-        return 0;
-    }
-}
-
 REGISTER_CONTROLLER(PDCtrl, "kilobot_pd_controller")
@@ -20,13 +20,16 @@
 #define PD_CTRL_H
 
 #include "abstractga_ctrl.h"
+#include "payoff.h"
 
 /**
  * @brief The PDCtrl class.
- * Prisoner's Dilemma game
+ * Social dilemma game with abstention (Prisoner's Dilemma by default).
+ * The game is chosen in the XML, e.g., <params game="snowdrift" />, or
+ * given as a custom matrix, e.g., <params payoff="3,0,2,5,1,2,2,2,2" />.
  * @author Marcos Cardinot <mcardinot@gmail.com>
  */
-class PDCtrl : public AbstractGACtrl
+class PDCtrl : public TypedGACtrl<uint8_t>
 {
 
 public:
@@ -34,10 +37,10 @@ public:
     virtual ~PDCtrl() {}
 
     // generate a random gene (pure game strategy)
-    virtual QVariant randGene() const;
+    virtual uint8_t randGene(RandomStream& rng) const;
 
-    // set chromosome (vector of motor speeds)
-    virtual bool setChromosome(Chromosome chromosome);
+    // set chromosome (a single gene holding the game strategy)
+    virtual bool setChromosome(const ChromosomeView& chromosome);
 
     // CCI_Controller stuff
     virtual void Init(TConfigurationNode &t_node);
@@ -49,7 +52,8 @@ private:
     uint8_t m_curStrategy;
     CColor m_curColor;
 
-    float calcPerformance(uint8_t sA, uint8_t sB);
+    const PayoffTable* m_pcPayoff;
+    const float* m_pfPayoffRow; // payoffs of the current strategy
 };
 
 #endif // PD_CTRL_H
@@ -0,0 +1,224 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+
+#ifdef KGA_PROFILING
+
+#include "record_file.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+thread_local ProfileThreadData* Profiler::s_local = NULL;
+
+// registry of all threads (never shrinks; data outlives its thread)
+static std::mutex s_mutex;
+static std::vector<std::unique_ptr<ProfileThreadData> > s_threads;
+static bool s_bCounters = false;
+
+// report
+static std::ofstream s_csv;
+static std::ofstream s_json;
+static uint64_t s_last[PROFILE_NUM_POINTS][2 + ProfileThreadData::NUM_COUNTERS];
+
+static int openCounter(uint32_t type, uint64_t config, int groupFd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // this thread, any cpu
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+ProfileThreadData::ProfileThreadData()
+    : perfFd(-1)
+{
+    for (int p = 0; p < PROFILE_NUM_POINTS; ++p) {
+        calls[p] = 0;
+        nanoseconds[p] = 0;
+        for (int c = 0; c < NUM_COUNTERS; ++c) {
+            counters[p][c] = 0;
+        }
+    }
+}
+
+bool ProfileThreadData::readCounters(uint64_t values[NUM_COUNTERS]) const
+{
+    if (perfFd < 0) {
+        return false;
+    }
+    // PERF_FORMAT_GROUP: number of counters followed by their values
+    uint64_t buf[1 + NUM_COUNTERS];
+    if (read(perfFd, buf, sizeof(buf)) != (ssize_t) sizeof(buf) || buf[0] != NUM_COUNTERS) {
+        return false;
+    }
+    memcpy(values, buf + 1, sizeof(uint64_t) * NUM_COUNTERS);
+    return true;
+}
+
+void Profiler::setCountersEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_bCounters = enabled;
+}
+
+ProfileThreadData* Profiler::registerThread()
+{
+    std::unique_ptr<ProfileThreadData> data(new ProfileThreadData());
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_bCounters) {
+        // e.g., not allowed by /proc/sys/kernel/perf_event_paranoid
+        int leader = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        int misses = leader < 0 ? -1 : openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader);
+        if (misses >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            data->perfFd = leader;
+        } else if (leader >= 0) {
+            ::close(leader);
+        }
+    }
+
+    s_local = data.get();
+    s_threads.push_back(std::move(data));
+    return s_local;
+}
+
+bool Profiler::open(const std::string& basePath, bool csv, bool json, int64_t lastGeneration, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    memset(s_last, 0, sizeof(s_last));
+
+    // when resuming, the records of the generations after the checkpoint are dropped
+    const std::ios::openmode mode = std::ios::out | (lastGeneration >= 0 ? std::ios::app : std::ios::trunc);
+
+    if (csv) {
+        const std::string fileName = basePath + ".csv";
+        const long kept = lastGeneration >= 0 ? truncateRecords(fileName, (uint32_t) lastGeneration) : 0;
+        s_csv.open(fileName.c_str(), mode);
+        if (kept < 0 || !s_csv) {
+            error = "Unable to write in " + fileName;
+            return false;
+        }
+        if (kept == 0) {
+            s_csv << "generation,point,calls,nanoseconds,cycles,cache_misses\n";
+        }
+    }
+
+    if (json) {
+        // one object per line (json lines)
+        const std::string fileName = basePath + ".json";
+        const long kept = lastGeneration >= 0 ? truncateRecords(fileName, (uint32_t) lastGeneration) : 0;
+        s_json.open(fileName.c_str(), mode);
+        if (kept < 0 || !s_json) {
+            error = "Unable to write in " + fileName;
+            return false;
+        }
+    }
+    return true;
+}
+
+void Profiler::close()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_csv.is_open()) s_csv.close();
+    if (s_json.is_open()) s_json.close();
+}
+
+void Profiler::report(uint32_t generation)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_csv.is_open() && !s_json.is_open()) {
+        return;
+    }
+
+    // totals since the beginning, then the difference to the last report
+    uint64_t total[PROFILE_NUM_POINTS][2 + ProfileThreadData::NUM_COUNTERS];
+    memset(total, 0, sizeof(total));
+    for (size_t t = 0; t < s_threads.size(); ++t) {
+        const ProfileThreadData& d = *s_threads[t];
+        for (int p = 0; p < PROFILE_NUM_POINTS; ++p) {
+            total[p][0] += d.calls[p].load(std::memory_order_relaxed);
+            total[p][1] += d.nanoseconds[p].load(std::memory_order_relaxed);
+            for (int c = 0; c < ProfileThreadData::NUM_COUNTERS; ++c) {
+                total[p][2 + c] += d.counters[p][c].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (s_json.is_open()) {
+        s_json << "{\"generation\":" << generation << ",\"points\":{";
+    }
+    for (int p = 0; p < PROFILE_NUM_POINTS; ++p) {
+        uint64_t delta[2 + ProfileThreadData::NUM_COUNTERS];
+        for (int i = 0; i < 2 + ProfileThreadData::NUM_COUNTERS; ++i) {
+            delta[i] = total[p][i] - s_last[p][i];
+            s_last[p][i] = total[p][i];
+        }
+
+        const char* name = pointName((ProfilePoint) p);
+        if (s_csv.is_open()) {
+            s_csv << generation << "," << name << "," << delta[0] << "," << delta[1]
+                  << "," << delta[2] << "," << delta[3] << "\n";
+        }
+        if (s_json.is_open()) {
+            s_json << (p ? "," : "") << "\"" << name << "\":{\"calls\":" << delta[0]
+                   << ",\"nanoseconds\":" << delta[1] << ",\"cycles\":" << delta[2]
+                   << ",\"cache_misses\":" << delta[3] << "}";
+        }
+    }
+    if (s_json.is_open()) {
+        s_json << "}}\n";
+        s_json.flush();
+    }
+    if (s_csv.is_open()) {
+        s_csv.flush();
+    }
+}
+
+const char* Profiler::pointName(ProfilePoint point)
+{
+    switch (point) {
+    case PROFILE_CONTROL_STEP: return "control_step";
+    case PROFILE_SIM_STEP: return "sim_step";
+    case PROFILE_RESET: return "reset";
+    case PROFILE_SELECT: return "select";
+    case PROFILE_BREED: return "breed";
+    case PROFILE_FLUSH: return "flush";
+    case PROFILE_SURROGATE: return "surrogate";
+    default: return "unknown";
+    }
+}
+
+#endif // KGA_PROFILING
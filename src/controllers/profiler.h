@@ -0,0 +1,174 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <string>
+
+/*
+ * Hot-path instrumentation, only compiled in with -DKGA_PROFILING=ON.
+ *
+ *   void Foo::ControlStep() {
+ *       KGA_PROFILE(PROFILE_CONTROL_STEP);
+ *       ...
+ *   }
+ *
+ * Each thread accumulates the number of calls and the time spent in each
+ * profile point (and, optionally, the cpu cycles and cache misses read from
+ * the Linux perf_event counters). Profiler::report() adds up all threads and
+ * writes one record per generation. Without KGA_PROFILING, KGA_PROFILE() and
+ * the Profiler calls compile to nothing.
+ */
+
+enum ProfilePoint {
+    PROFILE_CONTROL_STEP, // controller step (nested in PROFILE_SIM_STEP)
+    PROFILE_SIM_STEP,     // one simulation step
+    PROFILE_RESET,        // reset of the simulation and turnover of the generation
+    PROFILE_SELECT,       // selection of the parents
+    PROFILE_BREED,        // crossover and mutation
+    PROFILE_FLUSH,        // storage of a generation (writer thread)
+    PROFILE_SURROGATE,    // evaluation in the kinematic surrogate
+    PROFILE_NUM_POINTS
+};
+
+#ifdef KGA_PROFILING
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief The ProfileThreadData struct
+ * Totals of a single thread. Only the owner thread writes them, so relaxed
+ * atomics (i.e., plain loads and stores) are enough to read them anytime.
+ */
+struct ProfileThreadData {
+    enum Counter { CYCLES, CACHE_MISSES, NUM_COUNTERS };
+
+    std::atomic<uint64_t> calls[PROFILE_NUM_POINTS];
+    std::atomic<uint64_t> nanoseconds[PROFILE_NUM_POINTS];
+    std::atomic<uint64_t> counters[PROFILE_NUM_POINTS][NUM_COUNTERS];
+    int perfFd; // group of perf_event counters (-1 if disabled)
+
+    ProfileThreadData();
+
+    // current value of the counters; false if disabled
+    bool readCounters(uint64_t values[NUM_COUNTERS]) const;
+
+    static inline void add(std::atomic<uint64_t>& total, uint64_t value) {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief The Profiler class
+ * Registry of the per-thread totals and writer of the per-generation report.
+ * @author KilobotGA contributors
+ */
+class Profiler
+{
+
+public:
+    static inline bool available() { return true; }
+
+    // read the perf_event counters (threads created from now on)
+    static void setCountersEnabled(bool enabled);
+
+    // files of the report, i.e., 'basePath'.csv and/or 'basePath'.json;
+    // when resuming after 'lastGeneration' (-1 = new run), the report goes on
+    // from there; return false and set the error message if something went wrong
+    static bool open(const std::string& basePath, bool csv, bool json, int64_t lastGeneration, std::string& error);
+    static void close();
+
+    // add up all threads since the last report and write it for this generation
+    static void report(uint32_t generation);
+
+    static const char* pointName(ProfilePoint point);
+
+    // totals of the calling thread (created on first use)
+    static inline ProfileThreadData* local() {
+        return s_local ? s_local : registerThread();
+    }
+
+private:
+    static thread_local ProfileThreadData* s_local;
+    static ProfileThreadData* registerThread();
+};
+
+/**
+ * @brief The ScopedProfile class
+ * Adds the time (and counters) spent in its scope to a profile point.
+ */
+class ScopedProfile
+{
+
+public:
+    explicit inline ScopedProfile(ProfilePoint point)
+        : m_data(Profiler::local())
+        , m_point(point)
+    {
+        m_bCounters = m_data->readCounters(m_counters);
+        m_start = Clock::now();
+    }
+
+    inline ~ScopedProfile() {
+        const Clock::duration elapsed = Clock::now() - m_start;
+        ProfileThreadData::add(m_data->calls[m_point], 1);
+        ProfileThreadData::add(m_data->nanoseconds[m_point],
+                               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        uint64_t counters[ProfileThreadData::NUM_COUNTERS];
+        if (m_bCounters && m_data->readCounters(counters)) {
+            for (int c = 0; c < ProfileThreadData::NUM_COUNTERS; ++c) {
+                ProfileThreadData::add(m_data->counters[m_point][c], counters[c] - m_counters[c]);
+            }
+        }
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    ProfileThreadData* m_data;
+    ProfilePoint m_point;
+    bool m_bCounters;
+    uint64_t m_counters[ProfileThreadData::NUM_COUNTERS];
+    Clock::time_point m_start;
+};
+
+#define KGA_PROFILE_CONCAT_(a, b) a##b
+#define KGA_PROFILE_CONCAT(a, b) KGA_PROFILE_CONCAT_(a, b)
+#define KGA_PROFILE(point) ScopedProfile KGA_PROFILE_CONCAT(kgaProfile, __LINE__)(point)
+
+#else // KGA_PROFILING
+
+class Profiler
+{
+
+public:
+    static inline bool available() { return false; }
+    static inline void setCountersEnabled(bool) {}
+    static inline bool open(const std::string&, bool, bool, int64_t, std::string&) { return true; }
+    static inline void close() {}
+    static inline void report(uint32_t) {}
+};
+
+#define KGA_PROFILE(point) ((void) 0)
+
+#endif // KGA_PROFILING
+
+#endif // PROFILER_H
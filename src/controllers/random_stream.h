@@ -0,0 +1,143 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <argos3/core/utility/math/rng.h>
+
+#include <cstddef>
+#include <stdint.h>
+
+using namespace argos;
+
+/**
+ * @brief The RandomStream class
+ * Counter-based random number generator (Philox4x32-10, Salmon et al. 2011).
+ * Each block of four numbers is a pure function of a key (seed, robot) and a
+ * counter (generation, trial, position). So every robot has its own stream,
+ * which does not depend on the order in which the robots are stepped, and
+ * any position of a stream can be reached in O(1) with seek().
+ * Numbers are generated four at a time and served from a small buffer.
+ * @author KilobotGA contributors
+ */
+class RandomStream
+{
+
+public:
+    RandomStream() : m_iBlock(0), m_iNext(4) {
+        m_key[0] = m_key[1] = 0;
+        m_counter[0] = m_counter[1] = 0;
+    }
+
+    // select a stream and go to its beginning
+    inline void setKey(uint32_t seed, uint32_t robot) {
+        m_key[0] = seed;
+        m_key[1] = robot;
+        seek(0);
+    }
+    inline void setCounter(uint32_t generation, uint32_t trial) {
+        m_counter[0] = generation;
+        m_counter[1] = trial;
+        seek(0);
+    }
+
+    // position = number of values drawn since the beginning of the stream
+    inline uint64_t position() const { return 4 * m_iBlock - (4 - m_iNext); }
+    inline void seek(uint64_t position) {
+        m_iBlock = position / 4;
+        m_iNext = 4;
+        if (position % 4) {
+            refill();
+            m_iNext = position % 4;
+        }
+    }
+
+    inline uint32_t next() {
+        if (m_iNext == 4) {
+            refill();
+        }
+        return m_buffer[m_iNext++];
+    }
+
+    // the next 'n' values (the same as calling next() 'n' times);
+    // whole blocks are written straight to 'out'
+    inline void fill(uint32_t* out, size_t n) {
+        while (n > 0 && m_iNext < 4) {
+            *out++ = m_buffer[m_iNext++];
+            --n;
+        }
+        uint32_t c[4] = { 0, 0, m_counter[0], m_counter[1] };
+        for (; n >= 4; n -= 4, out += 4) {
+            c[0] = (uint32_t) m_iBlock;
+            c[1] = (uint32_t) (m_iBlock >> 32);
+            philox(m_key, c, out);
+            ++m_iBlock;
+        }
+        while (n > 0) {
+            *out++ = next();
+            --n;
+        }
+    }
+
+    // [0, 1)
+    inline double uniform() { return next() * (1.0 / 4294967296.0); }
+    // [min, max)
+    inline Real uniform(const CRange<Real>& range) {
+        return range.GetMin() + uniform() * range.GetSpan();
+    }
+    // [min, max) without division (Lemire's multiply-shift)
+    inline UInt32 uniform(const CRange<UInt32>& range) {
+        const uint64_t span = range.GetMax() - range.GetMin();
+        return range.GetMin() + (UInt32) ((next() * span) >> 32);
+    }
+    inline bool bernoulli(Real p = 0.5) { return uniform() < p; }
+
+    // the Philox4x32-10 bijection
+    static inline void philox(const uint32_t key[2], const uint32_t counter[4], uint32_t out[4]) {
+        uint32_t k0 = key[0], k1 = key[1];
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+            const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+            c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+            c1 = (uint32_t) p1;
+            c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+            c3 = (uint32_t) p0;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+private:
+    uint32_t m_key[2];     // seed, robot
+    uint32_t m_counter[2]; // generation, trial
+    uint64_t m_iBlock;     // next block to generate
+    uint32_t m_buffer[4];
+    uint32_t m_iNext;      // next value in the buffer (4 = empty)
+
+    inline void refill() {
+        const uint32_t counter[4] = { (uint32_t) m_iBlock, (uint32_t) (m_iBlock >> 32), m_counter[0], m_counter[1] };
+        philox(m_key, counter, m_buffer);
+        ++m_iBlock;
+        m_iNext = 0;
+    }
+};
+
+#endif // RANDOM_STREAM_H
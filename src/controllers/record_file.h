@@ -0,0 +1,80 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+
+/*
+ * Per-generation records are appended to text files: csv lines starting with
+ * the generation, or json lines starting with {"generation":N. A run resumed
+ * from a checkpoint evaluates again the generations after the checkpoint, so
+ * the records left by the interrupted run for those generations are dropped
+ * before the file is reopened.
+ */
+
+// keep the records up to 'lastGeneration' and the lines which are not
+// records (e.g., a csv header); return the number of lines kept (0 if the
+// file does not exist), or -1 if the file could not be rewritten
+inline long truncateRecords(const std::string& fileName, uint32_t lastGeneration)
+{
+    std::ifstream in(fileName.c_str());
+    if (!in) {
+        return 0;
+    }
+
+    // written aside, so a crash leaves the file untouched
+    const std::string tmpName = fileName + ".tmp";
+    std::ofstream out(tmpName.c_str(), std::ios::out | std::ios::trunc);
+    if (!out) {
+        return -1;
+    }
+
+    static const char jsonKey[] = "{\"generation\":";
+    long kept = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        const char* p = line.c_str();
+        if (strncmp(p, jsonKey, sizeof(jsonKey) - 1) == 0) {
+            p += sizeof(jsonKey) - 1;
+        }
+        char* end = NULL;
+        const unsigned long generation = strtoul(p, &end, 10);
+        if (end != p && generation > lastGeneration) {
+            continue;
+        }
+        out << line << '\n';
+        ++kept;
+    }
+
+    in.close();
+    out.close();
+    if (!out || std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+        return -1;
+    }
+    return kept;
+}
+
+#endif // RECORD_FILE_H
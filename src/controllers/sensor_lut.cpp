@@ -0,0 +1,74 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sensor_lut.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+typedef std::pair<std::vector<uint8_t>, uint8_t> SensorLUTKey;
+
+static std::mutex s_mutex;
+static std::map<SensorLUTKey, std::unique_ptr<SensorLUT> > s_tables;
+
+SensorLUT::SensorLUT(const std::vector<uint8_t>& bounds, uint8_t maxReading)
+    : m_bounds(bounds)
+    , m_iMaxReading(maxReading)
+{
+    const uint16_t last = m_bounds.empty() ? 0 : (uint16_t) (m_bounds.size() - 1);
+    for (int reading = 0; reading < 256; ++reading) {
+        m_index[reading] = last;
+        if (reading > maxReading) {
+            continue; // no signal
+        }
+        for (size_t idx = 0; idx < m_bounds.size(); ++idx) {
+            if (reading < m_bounds[idx]) {
+                m_index[reading] = (uint16_t) idx;
+                break;
+            }
+        }
+    }
+}
+
+const SensorLUT* SensorLUT::get(const std::vector<uint8_t>& bounds, uint8_t maxReading)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    std::unique_ptr<SensorLUT>& table = s_tables[SensorLUTKey(bounds, maxReading)];
+    if (!table) {
+        table.reset(new SensorLUT(bounds, maxReading));
+    }
+    return table.get();
+}
+
+const SensorLUT* SensorLUT::linear(uint8_t minReading, uint8_t maxReading, size_t size)
+{
+    // first and last elements hold the decision for MIN and MAX reading
+    // i.e., [min, ... , no-signal]
+    const int interval = round((maxReading - minReading) / (double)(size - 2.0));
+    std::vector<uint8_t> bounds;
+    bounds.reserve(size);
+    int reading = minReading;
+    for (size_t i = 0; i < size; ++i) {
+        bounds.push_back((uint8_t) reading);
+        reading += interval;
+    }
+    return get(bounds, maxReading);
+}
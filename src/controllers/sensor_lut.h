@@ -0,0 +1,58 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SENSOR_LUT_H
+#define SENSOR_LUT_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief The SensorLUT class
+ * Maps a discretised sensor reading (uint8_t) to a gene index in O(1).
+ * The bins are given by their upper bounds: a reading goes to the first bin
+ * whose bound is greater than it; readings above 'maxReading' (no signal)
+ * and those beyond the last bound go to the last bin.
+ * Tables are immutable and shared by all controllers using the same bins.
+ * @author KilobotGA contributors
+ */
+class SensorLUT
+{
+
+public:
+    // get the shared table for these bins (created on first use; thread-safe)
+    static const SensorLUT* get(const std::vector<uint8_t>& bounds, uint8_t maxReading);
+
+    // evenly spaced bins in [minReading, maxReading] plus one for 'no signal'
+    static const SensorLUT* linear(uint8_t minReading, uint8_t maxReading, size_t size);
+
+    inline uint16_t index(uint8_t reading) const { return m_index[reading]; }
+    inline size_t size() const { return m_bounds.size(); }
+    inline const std::vector<uint8_t>& bounds() const { return m_bounds; }
+    inline uint8_t maxReading() const { return m_iMaxReading; }
+
+private:
+    std::vector<uint8_t> m_bounds;
+    uint8_t m_iMaxReading;
+    uint16_t m_index[256];
+
+    SensorLUT(const std::vector<uint8_t>& bounds, uint8_t maxReading);
+};
+
+#endif // SENSOR_LUT_H
@@ -17,7 +17,9 @@
  */
 
 #include "abstractga_lf.h"
+#include "controllers/profiler.h"
 
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/configuration/tinyxml/ticpp.h>
 
@@ -25,10 +27,18 @@
 #include <QDateTime>
 #include <QDir>
 #include <QFile>
-#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 AbstractGALoopFunction::AbstractGALoopFunction()
     : m_iPopSize(10)
+    , m_iRobots(10)
     , m_iTournamentSize(2)
     , m_iMaxGenerations(1)
     , m_fMutationRate(0.f)
@@ -37,10 +47,47 @@ AbstractGALoopFunction::AbstractGALoopFunction()
     , m_arenaSideY(0, 0)
     , m_eSimMode(NEW_EXPERIMENT)
     , m_iCurGeneration(0)
+    , m_bBinaryOutput(true)
+    , m_bTextOutput(false)
+    , m_bProfileCSV(false)
+    , m_bProfileJSON(false)
+    , m_bStatsCSV(false)
+    , m_bStatsJSON(false)
+    , m_bInTrial(false)
+    , m_bEvolving(false)
+    , m_iPlaced(0)
+    , m_iLayoutSeed(0)
+    , m_iBaseSeed(0)
+    , m_iCheckpointInterval(10)
+    , m_bResumed(false)
+    , m_iArchiveSamples(0)
+    , m_fArchiveTolerance(0.05f)
+    , m_iSurrogateGenerations(0)
+    , m_iSurrogateScreening(0)
 {
     // create and seed our prg (using xml data)
     CRandom::CreateCategory("kilobotga", GetSimulator().GetRandomSeed());
     m_pcRNG = CRandom::CreateRNG("kilobotga");
+    m_pcPlacementRNG = CRandom::CreateRNG("kilobotga");
+    m_iBaseSeed = GetSimulator().GetRandomSeed();
+    m_operators.setRNG(m_pcRNG);
+
+    m_driver.setStep(GenerationDriver::RECORD, [this]() { recordGeneration(); });
+    m_driver.setStep(GenerationDriver::SELECT, [this]() {
+        reseed(m_iCurGeneration);
+        selectParents();
+    });
+    m_driver.setStep(GenerationDriver::BREED, [this]() { breed(); });
+    m_driver.setStep(GenerationDriver::RESET, [this]() {
+        KGA_PROFILE(PROFILE_RESET);
+        GetSimulator().Reset();
+        loadNextGeneration();
+    });
+    m_driver.setStep(GenerationDriver::EVALUATE, [this]() { evaluateGeneration(); });
+    // everything profiled since the last record belongs to this generation
+    m_driver.addHook(GenerationDriver::RECORD, [](uint32_t generation) { Profiler::report(generation); });
+    m_driver.addHook(GenerationDriver::RECORD, [this](uint32_t generation) { migrate(generation); });
+    m_driver.addHook(GenerationDriver::RECORD, [this](uint32_t generation) { saveCheckpoint(generation); });
 }
 
 void AbstractGALoopFunction::Init(TConfigurationNode& t_node)
@@ -51,23 +98,217 @@ void AbstractGALoopFunction::Init(TConfigurationNode& t_node)
     GetNodeAttribute(t_node, "tournament_size", m_iTournamentSize);
     GetNodeAttribute(t_node, "mutation_rate", m_fMutationRate);
     GetNodeAttribute(t_node, "crossover_rate", m_fCrossoverRate);
+    m_operators.setTournamentSize(m_iTournamentSize);
+    m_operators.setMutationRate(m_fMutationRate);
+    m_operators.setCrossoverRate(m_fCrossoverRate);
 
-    // TODO: we should get it from the XML too
-    // we need the arena size to position the kilobots
-    m_arenaSideX = CRange<Real>(-0.5, 0.5);
-    m_arenaSideY = CRange<Real>(-0.5, 0.5);
+    // the population can be evaluated by a smaller swarm of 'group_size'
+    // robots (0 = population_size), in 'random' (default) or 'clonal' groups
+    uint32_t groupSize = 0;
+    std::string groupingName;
+    GetNodeAttributeOrDefault(t_node, "group_size", groupSize, groupSize);
+    GetNodeAttributeOrDefault(t_node, "grouping", groupingName, std::string("random"));
+    BatchPlan::Grouping grouping;
+    if (!BatchPlan::parseGrouping(groupingName, grouping)) {
+        qFatal("\n[FATAL] Invalid value for grouping (%s). Should be 'random' or 'clonal'.", groupingName.c_str());
+    }
+    if (groupSize > m_iPopSize) {
+        qFatal("\n[FATAL] Invalid value for group_size (%d). Should not be greater than the population size.", groupSize);
+    }
+    m_iRobots = groupSize > 0 ? groupSize : m_iPopSize;
+    m_batches.setup(m_iPopSize, m_iRobots, grouping);
 
-    m_nextGeneration.reserve(m_iPopSize);
+    // selection: 'tournament' (default), 'rank', 'roulette' or 'sus';
+    // the best 'elitism' robots always survive unchanged
+    std::string selectionName;
+    uint32_t elitism = 1;
+    GetNodeAttributeOrDefault(t_node, "selection", selectionName, std::string("tournament"));
+    GetNodeAttributeOrDefault(t_node, "elitism", elitism, elitism);
+    GeneticOperators::Selection selection;
+    if (!GeneticOperators::parseSelection(selectionName, selection)) {
+        qFatal("\n[FATAL] Invalid value for selection (%s). Should be 'tournament', 'rank', 'roulette' or 'sus'.",
+               selectionName.c_str());
+    }
+    if (elitism >= m_iPopSize) {
+        qFatal("\n[FATAL] Invalid value for elitism (%d). Should be smaller than the population size.", elitism);
+    }
+    m_operators.setSelection(selection);
+    m_operators.setElitism(elitism);
 
-    // Create the kilobots and get a reference to their controllers
-    for (uint32_t id = 0; id < m_iPopSize; ++id) {
-        std::stringstream entityId;
-        entityId << "kb" << id;
-        // fcc is the controller id as set in the XML
-        CKilobotEntity* kilobot = new CKilobotEntity(entityId.str(), "fcc");
-        AddEntity(*kilobot);
-        m_entities.push_back(kilobot);
-        m_controllers.push_back(&dynamic_cast<AbstractGACtrl&>(kilobot->GetControllableEntity().GetController()));
+    // the offspring are bred by 'breed_threads' threads (0 = one per core);
+    // the result does not depend on it
+    uint32_t breedThreads = 0;
+    GetNodeAttributeOrDefault(t_node, "breed_threads", breedThreads, breedThreads);
+    m_operators.setThreads(breedThreads);
+
+    // fitness archive: remembers the fitness of up to 'fitness_archive' genomes
+    // (0 = disabled) and selects them by their mean over all evaluations; once
+    // every genome of a generation has 'archive_samples' samples and a standard
+    // error below 'archive_tolerance' (relative to its mean), the generation
+    // is not simulated again
+    uint32_t archiveCapacity = 0;
+    GetNodeAttributeOrDefault(t_node, "fitness_archive", archiveCapacity, archiveCapacity);
+    GetNodeAttributeOrDefault(t_node, "archive_samples", m_iArchiveSamples, m_iArchiveSamples);
+    GetNodeAttributeOrDefault(t_node, "archive_tolerance", m_fArchiveTolerance, m_fArchiveTolerance);
+    if (m_fArchiveTolerance < 0.f) {
+        qFatal("\n[FATAL] Invalid value for archive_tolerance (%f). Should be a positive number.", m_fArchiveTolerance);
+    }
+    m_fitnessArchive.setCapacity(archiveCapacity);
+
+    // output format: 'binary' (default), 'text' or 'both'
+    std::string output;
+    GetNodeAttributeOrDefault(t_node, "output", output, std::string("binary"));
+    m_bBinaryOutput = output == "binary" || output == "both";
+    m_bTextOutput = output == "text" || output == "both";
+    if (!m_bBinaryOutput && !m_bTextOutput) {
+        qFatal("\n[FATAL] Invalid value for output (%s). Should be 'binary', 'text' or 'both'.", output.c_str());
+    }
+
+    // the binary archive stores a full generation every 'keyframe_interval'
+    // generations and only the changes in between (1 = full generations only)
+    uint32_t keyframeInterval = 10;
+    GetNodeAttributeOrDefault(t_node, "keyframe_interval", keyframeInterval, keyframeInterval);
+    if (keyframeInterval == 0) {
+        qFatal("\n[FATAL] Invalid value for keyframe_interval (%d). Should be a positive integer.", keyframeInterval);
+    }
+    m_archive.setKeyframeInterval(keyframeInterval);
+
+    // each generation can be evaluated in several trials (in parallel);
+    // the trials run in forked processes, which do not get the worker
+    // threads of ARGoS, so they need <system threads="0" />
+    uint32_t trials = 1;
+    uint32_t trialWorkers = 0;
+    std::string aggregationName;
+    GetNodeAttributeOrDefault(t_node, "trials", trials, trials);
+    GetNodeAttributeOrDefault(t_node, "trial_workers", trialWorkers, trialWorkers);
+    GetNodeAttributeOrDefault(t_node, "trial_aggregation", aggregationName, std::string("mean"));
+    TrialRunner::Aggregation aggregation;
+    if (!TrialRunner::parseAggregation(aggregationName, aggregation)) {
+        qFatal("\n[FATAL] Invalid value for trial_aggregation (%s). Should be 'mean', 'median' or 'min'.",
+               aggregationName.c_str());
+    }
+    if (trials > 1 && GetSimulator().GetNumThreads() > 0) {
+        qFatal("\n[FATAL] Invalid value for trials (%d). Several trials need <system threads=\"0\" />.", trials);
+    }
+    m_trials.setTrials(trials);
+    m_trials.setWorkers(trialWorkers);
+    m_trials.setAggregation(aggregation);
+
+    // island model: 'islands' subpopulations of 'population_size' robots, each
+    // one in its own process; every 'migration_interval' generations, copies of
+    // the best 'migrants' robots of an island go to its neighbours. Migrants
+    // arrive whenever they are ready, so such runs are not reproducible and
+    // resuming them is approximate
+    uint32_t islands = 1;
+    uint32_t migrationInterval = 10;
+    uint32_t migrants = 1;
+    std::string topologyName;
+    GetNodeAttributeOrDefault(t_node, "islands", islands, islands);
+    GetNodeAttributeOrDefault(t_node, "migration_interval", migrationInterval, migrationInterval);
+    GetNodeAttributeOrDefault(t_node, "migrants", migrants, migrants);
+    GetNodeAttributeOrDefault(t_node, "migration_topology", topologyName, std::string("ring"));
+    IslandModel::Topology topology;
+    if (!IslandModel::parseTopology(topologyName, topology)) {
+        qFatal("\n[FATAL] Invalid value for migration_topology (%s). Should be 'ring', 'full' or 'random'.",
+               topologyName.c_str());
+    }
+    m_islands.setIslands(islands);
+    m_islands.setInterval(migrationInterval);
+    m_islands.setMigrants(migrants);
+    m_islands.setTopology(topology);
+
+    // save the state of the evolution every 'checkpoint_interval' generations
+    // (0 disables it); resume="<results directory>" continues from there
+    std::string resumePath;
+    GetNodeAttributeOrDefault(t_node, "checkpoint_interval", m_iCheckpointInterval, m_iCheckpointInterval);
+    GetNodeAttributeOrDefault(t_node, "resume", resumePath, std::string());
+
+    // results directory of a new experiment (default: named after the current time)
+    std::string outputDir;
+    GetNodeAttributeOrDefault(t_node, "output_dir", outputDir, std::string());
+
+    // area where the kilobots are placed, e.g., arena_x="-0.45:0.45";
+    // the centres of the robots stay one radius away from its borders
+    GetNodeAttributeOrDefault(t_node, "arena_x", m_arenaSideX, CRange<Real>(-0.5, 0.5));
+    GetNodeAttributeOrDefault(t_node, "arena_y", m_arenaSideY, CRange<Real>(-0.5, 0.5));
+    m_placement.setArena(m_arenaSideX, m_arenaSideY);
+
+    // layout: 'uniform' (default), 'lattice' or 'poisson'
+    std::string placementName;
+    GetNodeAttributeOrDefault(t_node, "placement", placementName, std::string("uniform"));
+    Placement::Method placementMethod;
+    if (!Placement::parseMethod(placementName, placementMethod)) {
+        qFatal("\n[FATAL] Invalid value for placement (%s). Should be 'uniform', 'lattice' or 'poisson'.",
+               placementName.c_str());
+    }
+    m_placement.setMethod(placementMethod);
+
+    // minimum distance between the center of two kilobots (in meters)
+    Real spacing = 0.035;
+    GetNodeAttributeOrDefault(t_node, "placement_spacing", spacing, spacing);
+    m_placement.setMinDistance(spacing);
+
+    // kinematic surrogate (see surrogate.h): the first 'surrogate_generations'
+    // generations are only evaluated by it, and the offspring of every
+    // generation go through 'surrogate_screening' rounds in which those below
+    // the median surrogate fitness are bred again (0 disables both)
+    GetNodeAttributeOrDefault(t_node, "surrogate_generations", m_iSurrogateGenerations, m_iSurrogateGenerations);
+    GetNodeAttributeOrDefault(t_node, "surrogate_screening", m_iSurrogateScreening, m_iSurrogateScreening);
+
+    // racing: every 'race_interval' ticks, the final fitness of each robot is
+    // projected within 'race_confidence' standard deviations; the evaluation
+    // stops as soon as the ranking can no longer change (a 'race_tolerance'
+    // fraction of the non-elite neighbours may still overlap)
+    bool racing = false;
+    uint32_t raceInterval = 50;
+    float raceConfidence = 2.f;
+    float raceTolerance = 0.f;
+    GetNodeAttributeOrDefault(t_node, "racing", racing, racing);
+    GetNodeAttributeOrDefault(t_node, "race_interval", raceInterval, raceInterval);
+    GetNodeAttributeOrDefault(t_node, "race_confidence", raceConfidence, raceConfidence);
+    GetNodeAttributeOrDefault(t_node, "race_tolerance", raceTolerance, raceTolerance);
+    if (raceInterval == 0 || raceConfidence <= 0.f || raceTolerance < 0.f || raceTolerance > 1.f) {
+        qFatal("\n[FATAL] Invalid racing settings. race_interval and race_confidence should be positive, "
+               "race_tolerance should be in [0, 1].");
+    }
+    m_race.setEnabled(racing);
+    m_race.setInterval(raceInterval);
+    m_race.setConfidence(raceConfidence);
+    m_race.setTolerance(raceTolerance);
+    m_race.setElite(elitism);
+
+    // profiling report: 'none' (default), 'csv', 'json' or 'both'
+    // only available when built with -DKGA_PROFILING=ON
+    std::string profile;
+    bool profileCounters = false;
+    GetNodeAttributeOrDefault(t_node, "profile", profile, std::string("none"));
+    GetNodeAttributeOrDefault(t_node, "profile_counters", profileCounters, profileCounters);
+    m_bProfileCSV = profile == "csv" || profile == "both";
+    m_bProfileJSON = profile == "json" || profile == "both";
+    if (!m_bProfileCSV && !m_bProfileJSON && profile != "none") {
+        qFatal("\n[FATAL] Invalid value for profile (%s). Should be 'none', 'csv', 'json' or 'both'.", profile.c_str());
+    }
+    if ((m_bProfileCSV || m_bProfileJSON) && !Profiler::available()) {
+        LOGERR << "Profiling is disabled in this build (see KGA_PROFILING); no report will be written." << std::endl;
+    }
+    Profiler::setCountersEnabled(profileCounters);
+
+    // statistics of each generation: 'none' (default), 'csv', 'json' or 'both'
+    std::string stats;
+    GetNodeAttributeOrDefault(t_node, "stats", stats, std::string("none"));
+    m_bStatsCSV = stats == "csv" || stats == "both";
+    m_bStatsJSON = stats == "json" || stats == "both";
+    if (!m_bStatsCSV && !m_bStatsJSON && stats != "none") {
+        qFatal("\n[FATAL] Invalid value for stats (%s). Should be 'none', 'csv', 'json' or 'both'.", stats.c_str());
+    }
+
+    createRobots();
+
+    // move the (random) genes of each robot to our population buffer
+    initPopulation();
+
+    if (m_iSurrogateGenerations > 0 || m_iSurrogateScreening > 0) {
+        initSurrogate();
     }
 
     // reset everything first
@@ -79,41 +320,138 @@ void AbstractGALoopFunction::Init(TConfigurationNode& t_node)
     if (readFromFile) {
         // if we're reading from files (i.e., reproducing an old experiment),
         // we need to load the LUT for each kilobot
+        std::string replay;
+        GetNodeAttributeOrDefault(t_node, "replay_generation", replay, std::string("last"));
         m_eSimMode = READ_EXPERIMENT;
-        loadExperiment();
+        loadExperiment(QString::fromStdString(replay));
         qDebug() << "\nReading from file... \n";
     } else {
-        QTextStream stream(stdin);
-        int option = -1;
-        while (option < 0 || option > 1) {
-            qDebug() << "\nWhat do you want to do?\n"
-                     << "\t 0 : Run a new experiment (no visualization) [DEFAULT] \n"
-                     << "\t 1 : Test xml settings (visualize a single run)";
-            option = stream.readLine().toInt();
+        // 'evolve' (default): run a new experiment (no visualization)
+        // 'test': test the xml settings (visualize a single run)
+        std::string mode;
+        GetNodeAttributeOrDefault(t_node, "mode", mode, std::string("evolve"));
+        if (mode == "evolve") {
+            m_eSimMode = NEW_EXPERIMENT;
+        } else if (mode == "test") {
+            m_eSimMode = TEST_SETTINGS;
+        } else {
+            qFatal("\n[FATAL] Invalid value for mode (%s). Should be 'evolve' or 'test'.", mode.c_str());
         }
-
-        m_eSimMode = (SIMULATION_MODE) option;
     }
 
     // if we are running a new experiment,
     // then we should prepare the directories
     if (m_eSimMode == NEW_EXPERIMENT) {
-        // try to create a new directory to store our results
-        m_sRelativePath = QDateTime::currentDateTime().toString("dd.MM.yy_hh.mm.ss");
         QDir dir(QDir::currentPath());
-        if (!dir.mkdir(m_sRelativePath)) {
-            qFatal("\n[FATAL] Unable to create a directory in %s\nResults will NOT be stored!\n",
-                   qUtf8Printable(dir.absolutePath().append(m_sRelativePath)));
-        } else if (dir.cd(m_sRelativePath)) {
-            // create new folders for each generation
-            for (uint32_t g = 0; g < m_iMaxGenerations; ++g) {
-                dir.mkdir(QString::number(g));
+        m_bResumed = !resumePath.empty();
+        if (m_bResumed) {
+            // carry on in the directory of the interrupted run
+            m_sRelativePath = QString::fromStdString(resumePath);
+            if (!dir.exists(m_sRelativePath)) {
+                qFatal("\n[FATAL] Unable to resume: %s does not exist!\n", resumePath.c_str());
+            }
+            if (m_islands.islands() > 1) {
+                LOGERR << "Resuming a run with several islands: the migrants which were "
+                       << "on their way are lost, so it will not match the interrupted run." << std::endl;
+            }
+        } else {
+            // try to create a new directory to store our results
+            bool created;
+            if (outputDir.empty()) {
+                m_sRelativePath = QDateTime::currentDateTime().toString("dd.MM.yy_hh.mm.ss");
+                created = dir.mkdir(m_sRelativePath);
+            } else {
+                m_sRelativePath = QString::fromStdString(outputDir);
+                created = dir.mkpath(m_sRelativePath);
+            }
+            if (!created) {
+                qFatal("\n[FATAL] Unable to create a directory in %s\nResults will NOT be stored!\n",
+                       qUtf8Printable(dir.absolutePath().append(m_sRelativePath)));
+            }
+        }
+
+        // from here on, each island runs in its own process (and directory)
+        if (m_islands.islands() > 1) {
+            startIsland();
+        }
+
+        if (dir.cd(m_sRelativePath)) {
+            if (m_bResumed) {
+                loadCheckpoint(dir.absoluteFilePath(CHECKPOINT_FILENAME));
+            }
+
+            // a single file holds all generations
+            if (m_bBinaryOutput && m_bResumed) {
+                if (!m_archive.reopen(dir.absoluteFilePath(ARCHIVE_FILENAME), m_iCurGeneration)) {
+                    qFatal("\n[FATAL] %s\n", qUtf8Printable(m_archive.errorString()));
+                }
+                if (m_archive.header().popSize != m_iPopSize
+                        || m_archive.header().chromosomeStride != m_population.stride()
+                        || m_archive.header().maxGenerations < m_iMaxGenerations) {
+                    qFatal("\n[FATAL] The archive does not match the XML settings!\n");
+                }
+            } else if (m_bBinaryOutput) {
+                const ChromosomeView& c = m_population.current(0);
+                if (!m_archive.open(dir.absoluteFilePath(ARCHIVE_FILENAME),
+                                    m_controllers[0]->geneDescriptor(), c.size(),
+                                    m_population.stride(), m_iPopSize, m_iMaxGenerations)) {
+                    qFatal("\n[FATAL] %s\n", qUtf8Printable(m_archive.errorString()));
+                }
             }
 
-            // copy the .argos file
-            SetNodeAttribute(t_node, "read_from_file", "true");
-            t_node.GetDocument()->SaveFile(QString(m_sRelativePath + "/exp.argos").toStdString());
-            SetNodeAttribute(t_node, "read_from_file", "false");
+            // results are written in background
+            if (m_bStatsCSV || m_bStatsJSON) {
+                std::string error;
+                if (!m_stats.open(dir.absoluteFilePath("stats").toStdString(),
+                                  m_bStatsCSV, m_bStatsJSON, m_bResumed ? (int64_t) m_iCurGeneration : -1, error)) {
+                    qFatal("\n[FATAL] %s\n", error.c_str());
+                }
+                m_writer.addSink([this](const GenerationSnapshot& s, QString& error) {
+                    KGA_PROFILE(PROFILE_FLUSH);
+                    m_stats.summarize(s);
+                    genotypeStats(s, m_stats);
+                    std::string e;
+                    if (!m_stats.write(e)) {
+                        error = QString::fromStdString(e);
+                        return false;
+                    }
+                    return true;
+                });
+            }
+            if (m_bBinaryOutput) {
+                m_writer.addSink([this](const GenerationSnapshot& s, QString& error) {
+                    KGA_PROFILE(PROFILE_FLUSH);
+                    if (!m_archive.writeGeneration(s.generation, s.fitness.data(), s.genes.data(),
+                                                   s.parents.empty() ? NULL : s.parents.data())) {
+                        error = m_archive.errorString();
+                        return false;
+                    }
+                    return true;
+                });
+            }
+            if (m_bTextOutput) {
+                m_writer.addSink([this](const GenerationSnapshot& s, QString& error) {
+                    KGA_PROFILE(PROFILE_FLUSH);
+                    return flushGeneration(s, error);
+                });
+            }
+            m_writer.start();
+
+            if (m_bProfileCSV || m_bProfileJSON) {
+                std::string error;
+                if (!Profiler::open(dir.absoluteFilePath("profile").toStdString(),
+                                    m_bProfileCSV, m_bProfileJSON,
+                                    m_bResumed ? (int64_t) m_iCurGeneration : -1, error)) {
+                    qFatal("\n[FATAL] %s\n", error.c_str());
+                }
+            }
+
+            // copy the .argos file (the one of the first run is kept)
+            if (!m_bResumed) {
+                SetNodeAttribute(t_node, "read_from_file", "true");
+                t_node.GetDocument()->SaveFile(QString(m_sRelativePath + "/exp.argos").toStdString());
+                SetNodeAttribute(t_node, "read_from_file", "false");
+            }
 
             // hide visualization during evolution
             t_node.GetDocument()->FirstChildElement()->FirstChildElement()->NextSiblingElement("visualization")->Clear();
@@ -121,159 +459,819 @@ void AbstractGALoopFunction::Init(TConfigurationNode& t_node)
     }
 }
 
+void AbstractGALoopFunction::createRobots()
+{
+    // compute the layout first, so that each robot is created where it belongs
+    m_pcPlacementRNG->Reset();
+    m_iLayoutSeed = m_pcPlacementRNG->GetSeed();
+    m_iPlaced = m_placement.generate(m_iRobots, m_pcPlacementRNG, m_layout);
+    if (m_iPlaced < m_iRobots) {
+        LOGERR << "The arena is too small for " << m_iRobots << " kilobots; "
+               << m_iRobots - m_iPlaced << " of them may not be placed." << std::endl;
+    }
+
+    m_entities.reserve(m_iRobots);
+    m_controllers.reserve(m_iRobots);
+
+    // Create the kilobots and get a reference to their controllers
+    for (uint32_t id = 0; id < m_iRobots; ++id) {
+        std::stringstream entityId;
+        entityId << "kb" << id;
+        CQuaternion orientation;
+        orientation.FromEulerAngles(CRadians(m_layout[id].angle), CRadians::ZERO, CRadians::ZERO); // z, y, x
+        // fcc is the controller id as set in the XML
+        CKilobotEntity* kilobot = new CKilobotEntity(entityId.str(), "fcc",
+                                                     CVector3(m_layout[id].x, m_layout[id].y, 0), orientation);
+        AddEntity(*kilobot);
+        m_entities.push_back(kilobot);
+        m_controllers.push_back(&dynamic_cast<AbstractGACtrl&>(kilobot->GetControllableEntity().GetController()));
+    }
+    checkLayout();
+}
+
 void AbstractGALoopFunction::Reset()
 {
+    m_race.start(m_iRobots, GetSimulator().GetMaxSimulationClock());
+
     // make sure we reset our PRG before doing anything
     // it ensures that all kilobots will be back to the original position
-    m_pcRNG->Reset();
+    m_pcPlacementRNG->Reset();
+
+    // ARGoS puts each robot back to the pose it was created with, so if the
+    // layout is the same (same seed) only the relocated robots have to move
+    if (m_pcPlacementRNG->GetSeed() == m_iLayoutSeed) {
+        restoreLayout();
+        return;
+    }
+
+    m_iPlaced = m_placement.generate(m_iRobots, m_pcPlacementRNG, m_layout);
+    applyLayout();
+}
+
+void AbstractGALoopFunction::applyLayout()
+{
+    // the layout is free of overlaps, so the robots are moved without
+    // checking them against the old poses of the others
+    CQuaternion orientation;
+    for (size_t i = 0; i < m_iPlaced; ++i) {
+        orientation.FromEulerAngles(CRadians(m_layout[i].angle), CRadians::ZERO, CRadians::ZERO); // z, y, x
+        CVector3 position(m_layout[i].x, m_layout[i].y, 0);
+        MoveEntity(m_entities[i]->GetEmbodiedEntity(), position, orientation, false, true);
+    }
+    checkLayout();
+}
+
+void AbstractGALoopFunction::checkLayout()
+{
+    m_relocated.clear();
+
+    // no room left in the layout
+    for (size_t i = m_iPlaced; i < m_entities.size(); ++i) {
+        moveRandomly(i);
+    }
+
+    // each pose is checked once, e.g., against an obstacle which is not known by the layout
+    CQuaternion orientation;
+    for (size_t i = 0; i < m_iPlaced; ++i) {
+        orientation.FromEulerAngles(CRadians(m_layout[i].angle), CRadians::ZERO, CRadians::ZERO); // z, y, x
+        CVector3 position(m_layout[i].x, m_layout[i].y, 0);
+        if (!MoveEntity(m_entities[i]->GetEmbodiedEntity(), position, orientation, true)) {
+            moveRandomly(i);
+        }
+    }
+}
 
+void AbstractGALoopFunction::restoreLayout()
+{
+    // these poses were checked by checkLayout() with the other robots
+    // where they are now, so there is no need to check them again
+    CQuaternion orientation;
+    for (size_t k = 0; k < m_relocated.size(); ++k) {
+        const size_t i = m_relocated[k];
+        orientation.FromEulerAngles(CRadians(m_layout[i].angle), CRadians::ZERO, CRadians::ZERO); // z, y, x
+        CVector3 position(m_layout[i].x, m_layout[i].y, 0);
+        MoveEntity(m_entities[i]->GetEmbodiedEntity(), position, orientation, false, true);
+    }
+}
+
+void AbstractGALoopFunction::moveRandomly(size_t id)
+{
     CQuaternion orientation;
     CVector3 position;
+    CRadians zAngle;
     const int maxPosTrial = 100;
 
     // uniform distribution (random)
-    for (uint32_t i = 0; i < m_entities.size(); ++i) {
-        bool objAdded = false;
-        for (int posTrial = 0; posTrial < maxPosTrial; ++posTrial) {
-            CRadians zAngle = m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE);
-            orientation.FromEulerAngles(zAngle, CRadians::ZERO, CRadians::ZERO); // z, y, x
-            position = CVector3(m_pcRNG->Uniform(m_arenaSideX), m_pcRNG->Uniform(m_arenaSideY), 0);
-
-            if (MoveEntity(m_entities[i]->GetEmbodiedEntity(), position, orientation, false)) {
-                objAdded = true;
-                break;
-            }
+    for (int posTrial = 0; posTrial < maxPosTrial; ++posTrial) {
+        zAngle = m_pcPlacementRNG->Uniform(CRadians::UNSIGNED_RANGE);
+        orientation.FromEulerAngles(zAngle, CRadians::ZERO, CRadians::ZERO); // z, y, x
+        position = CVector3(m_pcPlacementRNG->Uniform(m_placement.arenaX()), m_pcPlacementRNG->Uniform(m_placement.arenaY()), 0);
+
+        if (MoveEntity(m_entities[id]->GetEmbodiedEntity(), position, orientation, false)) {
+            // the layout now holds where the robot is
+            m_layout[id].x = position.GetX();
+            m_layout[id].y = position.GetY();
+            m_layout[id].angle = zAngle.GetValue();
+            m_relocated.push_back(id);
+            return;
         }
+    }
+
+    LOGERR << "Unable to move robot to <" << position << ">, <" << orientation << ">" << std::endl;
+}
 
-        if (!objAdded) {
-            LOGERR << "Unable to move robot to <" << position << ">, <" << orientation << ">" << std::endl;
+void AbstractGALoopFunction::PostStep()
+{
+    if (m_eSimMode != NEW_EXPERIMENT || !m_race.enabled() || m_race.over()) {
+        return;
+    }
+
+    const UInt32 tick = GetSpace().GetSimulationClock();
+    if (tick % m_race.interval() == 0) {
+        m_racePerformance.resize(m_iRobots);
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            m_racePerformance[kbId] = m_controllers[kbId]->getPerformance();
         }
+        m_race.checkpoint(tick, m_racePerformance);
+    }
+}
+
+bool AbstractGALoopFunction::IsExperimentFinished()
+{
+    // unless the run started by ARGoS is a plain evaluation of the first
+    // generation, every generation is evaluated by evaluateGeneration() (in
+    // batches, trials, by the surrogate...), so this run should do nothing;
+    // the same goes for a resumed run, whose current generation was already evaluated
+    if (m_eSimMode == NEW_EXPERIMENT && (!plainEvaluation() || m_bResumed) && !m_bInTrial && !m_bEvolving) {
+        return true;
     }
+    return m_race.over();
+}
+
+bool AbstractGALoopFunction::plainEvaluation() const
+{
+    return m_batches.identity() && m_trials.trials() == 1
+            && m_iSurrogateGenerations == 0 && !m_fitnessArchive.enabled();
 }
 
 void AbstractGALoopFunction::PostExperiment()
 {
+    if (m_eSimMode != NEW_EXPERIMENT) {
+        gatherFitness();
+        LOG << "Generation " << m_iCurGeneration << "\t"
+            << GeneticOperators::total(m_fitness) << std::endl;
+        return;
+    }
+
+    // the driver takes care of the remaining generations in a loop
+    m_bEvolving = true;
+    if (m_bResumed) {
+        m_driver.run(m_iCurGeneration, m_iMaxGenerations, GenerationDriver::FROM_SELECT);
+    } else if (!plainEvaluation()) {
+        m_driver.run(m_iCurGeneration, m_iMaxGenerations, GenerationDriver::FROM_EVALUATE);
+    } else {
+        // ARGoS has just evaluated the first generation
+        gatherFitness();
+        m_driver.run(m_iCurGeneration, m_iMaxGenerations);
+    }
+
+    // wait for the last generations to be stored
+    m_writer.flush();
+    checkWriter();
+
+    // the first island waits for the others
+    QString error;
+    if (!m_islands.wait(error)) {
+        THROW_ARGOSEXCEPTION(error.toStdString());
+    }
+
+    LOG << "Time spent in each phase (s):";
+    for (int p = 0; p < GenerationDriver::NUM_PHASES; ++p) {
+        GenerationDriver::Phase phase = (GenerationDriver::Phase) p;
+        LOG << " " << GenerationDriver::phaseName(phase) << "=" << m_driver.totalTime(phase);
+    }
+    LOG << std::endl;
+}
+
+void AbstractGALoopFunction::recordGeneration()
+{
+    if (m_islands.islands() > 1) {
+        LOG << "Island " << m_islands.island() << "\t";
+    }
     LOG << "Generation " << m_iCurGeneration << "\t"
-        << getGlobalPerformance() << std::endl;
+        << GeneticOperators::total(m_fitness) << std::endl;
 
-    if (m_eSimMode == NEW_EXPERIMENT) {
-        flushGeneration();
-        ++m_iCurGeneration;
+    // an error in a previous generation stops the evolution
+    checkWriter();
 
-        if (m_iCurGeneration < m_iMaxGenerations) {
-            prepareNextGeneration();
+    // take a snapshot; the files are written while the next generation runs
+    GenerationSnapshot* snapshot = m_writer.acquire();
+    snapshot->generation = m_iCurGeneration;
+    snapshot->fitness = m_fitness;
+    snapshot->genes.assign(m_population.currentData(), m_population.currentData() + m_population.generationSize());
+    snapshot->stride = m_population.stride();
+    snapshot->geneSize = m_population.geneSize();
+    snapshot->length = m_population.chromosomeLength();
+    // where the offspring come from (helps the archive to store the changes only)
+    if (m_parents.size() == 2 * m_iPopSize) {
+        snapshot->parents = m_parents;
+    } else {
+        snapshot->parents.clear();
+    }
+    m_writer.submit(snapshot);
+}
+
+void AbstractGALoopFunction::checkWriter() const
+{
+    if (m_writer.hasError()) {
+        THROW_ARGOSEXCEPTION("Unable to store the results in " << m_sRelativePath.toStdString()
+                             << ": " << m_writer.errorString().toStdString());
+    }
+}
+
+void AbstractGALoopFunction::Destroy()
+{
+    // make sure nothing is lost
+    m_writer.stop();
+    m_archive.close();
+    m_stats.close();
+    Profiler::close();
+}
+
+void AbstractGALoopFunction::gatherFitness()
+{
+    // robot i holds genome i (used when not evolving)
+    m_fitness.assign(m_iPopSize, 0.f);
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        m_fitness[kbId] = performance(kbId);
+    }
+}
+
+void AbstractGALoopFunction::evaluatePopulation(std::vector<float>& fitness)
+{
+    fitness.resize(m_iPopSize);
+    if (m_batches.identity()) {
+        evaluate();
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            fitness[kbId] = performance(kbId);
+        }
+        return;
+    }
+
+    // the simulation has just been reset for the first batch
+    m_batches.clearScores();
+    for (uint32_t b = 0; b < m_batches.batches(); ++b) {
+        if (b > 0) {
             GetSimulator().Reset();
+        }
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            m_controllers[kbId]->setChromosome(m_population.current(m_batches.genome(b, kbId)));
+        }
+        evaluate();
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            m_batches.score(b, kbId, performance(kbId));
+        }
+    }
+    m_batches.fitness(fitness);
+}
 
-            loadNextGeneration();
-            GetSimulator().Execute();
+float AbstractGALoopFunction::performance(uint32_t kbId) const
+{
+    return m_race.over() ? m_race.projected(kbId) : m_controllers[kbId]->getPerformance();
+}
+
+QString AbstractGALoopFunction::generationPath(uint32_t generation) const
+{
+    const QString path = QString("%1/%2").arg(m_sRelativePath).arg(generation);
+    QDir(m_sRelativePath).mkpath(QString::number(generation));
+    return path;
+}
+
+void AbstractGALoopFunction::evaluate()
+{
+    // same as the main loop of ARGoS, but without calling PostExperiment()
+    while (!GetSimulator().IsExperimentFinished()) {
+        KGA_PROFILE(PROFILE_SIM_STEP);
+        GetSimulator().UpdateSpace();
+    }
+
+    if (m_race.enabled()) {
+        LOG << "Generation " << m_iCurGeneration << "\tracing: "
+            << m_race.ticksUsed() << "/" << GetSimulator().GetMaxSimulationClock() << " ticks" << std::endl;
+    }
+}
+
+void AbstractGALoopFunction::evaluateGeneration()
+{
+    // cheap fitness in the first generations
+    if (m_iCurGeneration < m_iSurrogateGenerations) {
+        evaluateSurrogate(false, m_fitness);
+        return;
+    }
+
+    if (m_fitnessArchive.enabled()) {
+        hashGenomes();
+        if (reuseArchivedFitness()) {
+            return;
+        }
+    }
+
+    // new groups every generation (drawn here, so all trials share them)
+    m_batches.plan(m_pcRNG);
+
+    if (m_trials.trials() == 1) {
+        evaluatePopulation(m_fitness);
+    } else {
+        QString error;
+        TrialRunner::Trial trial = [this](uint32_t t, std::vector<float>& fitness) { runTrial(t, fitness); };
+        if (!m_trials.run(trial, m_iPopSize, m_fitness, error)) {
+            THROW_ARGOSEXCEPTION("Unable to evaluate generation " << m_iCurGeneration
+                                 << ": " << error.toStdString());
         }
     }
+
+    if (m_fitnessArchive.enabled()) {
+        archiveFitness();
+    }
 }
 
-void AbstractGALoopFunction::prepareNextGeneration()
+void AbstractGALoopFunction::hashGenomes()
 {
-    m_nextGeneration.clear();
+    m_genomeHashes.resize(m_iPopSize);
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        m_genomeHashes[kbId] = FitnessArchive::hash(m_population.current(kbId));
+    }
+}
 
-    // elitism: keep the best robot
-    uint32_t bestId = getBestRobotId();
-    m_nextGeneration.push_back(m_controllers[bestId]->getChromosome());
+bool AbstractGALoopFunction::reuseArchivedFitness()
+{
+    if (m_iArchiveSamples == 0) {
+        return false;
+    }
 
-    const CRange<Real> zeroOne(0, 1);
+    // all genomes must be known well enough
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        const FitnessArchive::Entry* e = m_fitnessArchive.find(m_genomeHashes[kbId]);
+        if (e == NULL || e->count < m_iArchiveSamples
+                || e->stdError() > m_fArchiveTolerance * std::fabs(e->mean)) {
+            return false;
+        }
+    }
 
-    for (uint32_t i = 1; i < m_iPopSize; ++i) {
-        // select two individuals
-        uint32_t id1 = tournamentSelection();
-        uint32_t id2 = tournamentSelection();
-        // make sure they are different
-        while (id1 == id2) id2 = tournamentSelection();
+    m_fitness.resize(m_iPopSize);
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        m_fitness[kbId] = m_fitnessArchive.find(m_genomeHashes[kbId])->mean;
+    }
+    LOG << "Generation " << m_iCurGeneration << "\tall genomes are archived; evaluation skipped" << std::endl;
+    return true;
+}
 
-        Chromosome chromosome1 = m_controllers[id1]->getChromosome();
-        Chromosome chromosome2 = m_controllers[id2]->getChromosome();
-        Chromosome children = chromosome1;
+void AbstractGALoopFunction::archiveFitness()
+{
+    // every trial is a sample; duplicated genomes pool their samples
+    const uint32_t trials = m_trials.trials();
+    const std::vector<float>& results = trials == 1 ? m_fitness : m_trials.results();
+    for (uint32_t t = 0; t < trials; ++t) {
+        for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+            m_fitnessArchive.add(m_genomeHashes[kbId], results[t * m_iPopSize + kbId]);
+        }
+    }
 
-        // crossover
-        if (m_fCrossoverRate > 0.f) {
-            for (uint32_t i = 0; i < chromosome1.size(); ++i) {
-                if (m_pcRNG->Uniform(zeroOne) <= m_fCrossoverRate) {
-                    children[i] = chromosome2[i];
-                }
-            }
+    // robots are selected by the mean fitness of their genome
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        const FitnessArchive::Entry* e = m_fitnessArchive.find(m_genomeHashes[kbId]);
+        if (e != NULL) {
+            m_fitness[kbId] = e->mean;
         }
+    }
+}
 
-        // mutation
-        if (m_fMutationRate > 0.f) {
-            for (uint32_t i = 0; i < children.size(); ++i) {
-                if (m_pcRNG->Uniform(zeroOne) <= m_fMutationRate) {
-                    children[i] = m_controllers[id1]->randGene();
-                }
+void AbstractGALoopFunction::runTrial(uint32_t trial, std::vector<float>& fitness)
+{
+    // we are in a copy of the process; a new seed gives
+    // a new placement of the robots and new noise
+    m_bInTrial = true;
+    const UInt32 seed = GetSimulator().GetRandomSeed() + 7919 * (trial + 1);
+    m_pcPlacementRNG->SetSeed(seed);
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        m_controllers[kbId]->setSeed(m_iBaseSeed, kbId, m_iCurGeneration, trial + 1);
+    }
+    GetSimulator().Reset(seed);
+
+    evaluatePopulation(fitness);
+}
+
+void AbstractGALoopFunction::initPopulation()
+{
+    const ChromosomeView& c = m_controllers[0]->getChromosome();
+    m_population.allocate(m_iPopSize, c.geneSize(), c.size());
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        loadChromosome(kbId, m_controllers[kbId]->getChromosome());
+    }
+    // genomes without a robot of their own start with random genes too
+    for (uint32_t id = m_iRobots; id < m_iPopSize; ++id) {
+        ChromosomeView genes = m_population.current(id);
+        for (uint32_t g = 0; g < genes.size(); ++g) {
+            controllerOf(id)->fillRandGene(genes.at(g));
+        }
+    }
+}
+
+void AbstractGALoopFunction::startIsland()
+{
+    // the threads (e.g., writer) must be started after this point,
+    // as fork() only copies the calling thread
+    QString error;
+    if (!m_islands.start(m_population.current(0).byteSize(), error)) {
+        qFatal("\n[FATAL] %s\n", qUtf8Printable(error));
+    }
+
+    const uint32_t island = m_islands.island();
+    m_sRelativePath = QString("%1/island_%2").arg(m_sRelativePath).arg(island);
+    if (!QDir(QDir::currentPath()).mkpath(m_sRelativePath)) {
+        qFatal("\n[FATAL] Unable to create the directory %s\n", qUtf8Printable(m_sRelativePath));
+    }
+
+    // the first island keeps the population we have; the others start
+    // from their own random population (and random streams)
+    if (island == 0) {
+        return;
+    }
+    m_iBaseSeed += 104729 * island;
+    reseed(0);
+    for (uint32_t id = 0; id < m_iPopSize; ++id) {
+        ChromosomeView genes = m_population.current(id);
+        for (uint32_t g = 0; g < genes.size(); ++g) {
+            controllerOf(id)->fillRandGene(genes.at(g));
+        }
+        if (id < m_iRobots) {
+            m_controllers[id]->setChromosome(genes);
+        }
+    }
+}
+
+void AbstractGALoopFunction::reseed(uint32_t generation)
+{
+    // every stream restarts at each generation, so the state of the
+    // evolution is given by the population, its fitness and the generation
+    const UInt32 seed = m_iBaseSeed + 15485863 * generation;
+    m_pcRNG->SetSeed(seed);
+    m_pcRNG->Reset();
+    m_operators.setSeed(m_iBaseSeed, generation);
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        m_controllers[kbId]->setSeed(m_iBaseSeed, kbId, generation);
+    }
+}
+
+void AbstractGALoopFunction::saveCheckpoint(uint32_t generation)
+{
+    if (m_iCheckpointInterval == 0 || (generation + 1) % m_iCheckpointInterval != 0
+            || generation + 1 >= m_iMaxGenerations) {
+        return;
+    }
+
+    // the checkpoint must not get ahead of the stored results
+    m_writer.flush();
+    checkWriter();
+
+    Checkpoint checkpoint;
+    checkpoint.generation = generation;
+    checkpoint.seed = m_iBaseSeed;
+    checkpoint.gene = m_controllers[0]->geneDescriptor();
+    checkpoint.chromosomeLength = m_population.chromosomeLength();
+    checkpoint.fitness = m_fitness;
+    checkpoint.genes.resize(m_iPopSize * checkpoint.chromosomeBytes());
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        memcpy(checkpoint.chromosome(kbId), m_population.current(kbId).data(), checkpoint.chromosomeBytes());
+    }
+    m_fitnessArchive.records(checkpoint.archive);
+
+    QString error;
+    if (!checkpoint.save(QDir(m_sRelativePath).absoluteFilePath(CHECKPOINT_FILENAME), error)) {
+        THROW_ARGOSEXCEPTION(error.toStdString());
+    }
+}
+
+void AbstractGALoopFunction::loadCheckpoint(const QString& fileName)
+{
+    Checkpoint checkpoint;
+    QString error;
+    if (!checkpoint.load(fileName, error)) {
+        qFatal("\n[FATAL] Unable to resume: %s\n", qUtf8Printable(error));
+    }
+    if (checkpoint.popSize() != m_iPopSize
+            || !(checkpoint.gene == m_controllers[0]->geneDescriptor())
+            || checkpoint.chromosomeLength != m_population.chromosomeLength()) {
+        qFatal("\n[FATAL] The checkpoint does not match the XML settings!\n%s\n", qUtf8Printable(fileName));
+    }
+
+    m_iCurGeneration = checkpoint.generation;
+    m_iBaseSeed = checkpoint.seed;
+    m_fitness = checkpoint.fitness;
+    m_fitnessArchive.restore(checkpoint.archive);
+    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
+        ChromosomeView genes = m_population.current(kbId);
+        memcpy(genes.data(), checkpoint.chromosome(kbId), checkpoint.chromosomeBytes());
+        if (kbId < m_iRobots) {
+            m_controllers[kbId]->setChromosome(genes);
+        }
+    }
+
+    LOG << "Resuming from generation " << m_iCurGeneration << std::endl;
+}
+
+void AbstractGALoopFunction::migrate(uint32_t generation)
+{
+    if (!m_islands.migrationDue(generation)) {
+        return;
+    }
+
+    // best robots first
+    m_ranking.resize(m_iPopSize);
+    std::iota(m_ranking.begin(), m_ranking.end(), 0);
+    std::sort(m_ranking.begin(), m_ranking.end(), [this](uint32_t a, uint32_t b) {
+        return m_fitness[a] > m_fitness[b];
+    });
+
+    // emigrants: copies of the best robots
+    const uint32_t migrants = std::min<size_t>(m_islands.migrants(), m_iPopSize);
+    std::vector<uint32_t> destinations;
+    m_islands.destinations(m_pcRNG, destinations);
+    uint32_t dropped = 0;
+    for (size_t d = 0; d < destinations.size(); ++d) {
+        for (uint32_t i = 0; i < migrants; ++i) {
+            const uint32_t id = m_ranking[i];
+            if (!m_islands.send(destinations[d], m_fitness[id], m_population.current(id).data())) {
+                ++dropped;
             }
         }
+    }
 
-        m_nextGeneration.push_back(children);
+    // immigrants replace the worst robots (the best one is always kept)
+    uint32_t received = 0;
+    size_t worst = m_iPopSize - 1;
+    for (uint32_t source = 0; source < m_islands.islands(); ++source) {
+        if (source == m_islands.island()) {
+            continue;
+        }
+        float fitness;
+        while (worst > 0 && m_islands.receive(source, fitness, m_population.current(m_ranking[worst]).data())) {
+            m_fitness[m_ranking[worst]] = fitness;
+            --worst;
+            ++received;
+        }
     }
+
+    LOG << "Island " << m_islands.island() << "\t" << received << " immigrants, "
+        << dropped << " emigrants dropped" << std::endl;
 }
 
-void AbstractGALoopFunction::loadNextGeneration()
+bool AbstractGALoopFunction::loadChromosome(uint32_t kbId, const ChromosomeView& chromosome)
 {
+    ChromosomeView genes = m_population.current(kbId);
+    if (!genes.sameLayout(chromosome)) {
+        return false;
+    }
+    genes.copyFrom(chromosome);
+    return kbId >= m_iRobots || m_controllers[kbId]->setChromosome(genes);
+}
+
+void AbstractGALoopFunction::loadExperiment(QString generation)
+{
+    // the environment overrides the xml, e.g., KGA_GENERATION=best argos3 -c exp.argos
+    const QByteArray env = qgetenv("KGA_GENERATION");
+    if (!env.isEmpty()) {
+        generation = QString::fromUtf8(env);
+    }
+
+    bool isNumber = false;
+    m_iCurGeneration = generation.toUInt(&isNumber);
+    if (!isNumber && generation != "last" && generation != "best") {
+        qFatal("\n[FATAL] Invalid value for replay_generation (%s). Should be a generation, 'last' or 'best'.",
+               qUtf8Printable(generation));
+    }
+
+    QFileInfo path(QString::fromStdString(GetSimulator().GetExperimentFileName()));
+    QDir dir = path.absoluteDir();
+    const QString archiveName = dir.absoluteFilePath(ARCHIVE_FILENAME);
+    if (QFile::exists(archiveName)) {
+        loadArchivedGeneration(archiveName, generation);
+    } else {
+        // no binary archive; fall back to the text files
+        loadTextGeneration(dir, generation);
+    }
+    qDebug() << "\nReplaying generation" << m_iCurGeneration;
+}
+
+void AbstractGALoopFunction::loadArchivedGeneration(const QString& fileName, const QString& generation)
+{
+    ArchiveReader archive;
+    if (!archive.open(fileName)) {
+        qFatal("\n[FATAL] %s\n", qUtf8Printable(archive.errorString()));
+    }
+    if (archive.header().popSize != m_iPopSize
+            || !(archive.header().gene == m_controllers[0]->geneDescriptor())) {
+        qFatal("\n[FATAL] The archive does not match the XML settings!\n%s\n", qUtf8Printable(fileName));
+    }
+
+    if (generation == "last") {
+        const int last = archive.lastGeneration();
+        m_iCurGeneration = last < 0 ? 0 : last;
+    } else if (generation == "best") {
+        // the generation holding the fittest genome
+        float best = -std::numeric_limits<float>::max();
+        for (uint32_t g = 0; g < archive.header().maxGenerations; ++g) {
+            if (!archive.hasGeneration(g)) {
+                continue;
+            }
+            const float* fitness = archive.fitness(g);
+            const float max = *std::max_element(fitness, fitness + m_iPopSize);
+            if (max > best) {
+                best = max;
+                m_iCurGeneration = g;
+            }
+        }
+    }
+    if (!archive.hasGeneration(m_iCurGeneration)) {
+        qFatal("\n[FATAL] There is no data for this generation!\n%s\n", qUtf8Printable(fileName));
+    }
+
     for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        m_controllers[kbId]->setChromosome(m_nextGeneration[kbId]);
+        if (!loadChromosome(kbId, archive.chromosome(m_iCurGeneration, kbId))) {
+            qFatal("\n[FATAL] Something went wrong when loading the chromosome of robot %d: %s",
+                   kbId, qUtf8Printable(fileName));
+        }
     }
 }
 
-uint32_t AbstractGALoopFunction::tournamentSelection() const
+void AbstractGALoopFunction::loadTextGeneration(QDir dir, const QString& generation)
 {
-    // select random ids (make sure they are different)
-    std::vector<uint32_t> ids;
-    ids.reserve(m_iTournamentSize);
-    while (ids.size() < m_iTournamentSize) {
-        const uint32_t randId = m_pcRNG->Uniform(CRange<UInt32>(0, m_iPopSize));
+    if (generation == "best") {
+        qFatal("\n[FATAL] The fitness is only stored in the binary archive; 'best' needs output='binary' or 'both'.\n%s\n",
+               qUtf8Printable(dir.absolutePath()));
+    } else if (generation == "last") {
+        // the generations are the numbered subdirectories
+        bool found = false;
+        const QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (int i = 0; i < subdirs.size(); ++i) {
+            bool ok = false;
+            const uint32_t g = subdirs.at(i).toUInt(&ok);
+            if (ok && (!found || g > m_iCurGeneration)) {
+                m_iCurGeneration = g;
+                found = true;
+            }
+        }
+    }
+    if (!dir.cd(QString::number(m_iCurGeneration))) {
+        qFatal("\n[FATAL] There is no data for this generation!\n%s\n", qUtf8Printable(dir.absolutePath()));
+    }
+
+    // one file per genome; a missing file is caught while reading
+    if (dir.exists(QString("kb_%1.dat").arg(m_iPopSize))) {
+        qFatal("\n[FATAL] The folder for this generation should have %ld files!\n%s\n",
+               m_iPopSize, qUtf8Printable(dir.absolutePath()));
+    }
 
-        // check if randId has not already been chosen
-        bool exists = false;
-        for (uint32_t i = 0; i < ids.size(); ++i) {
-            if (randId == ids[i]) {
-                exists = true;
-                break;
+    // each file is read at once and parsed straight into the population,
+    // several files at a time
+    std::atomic<uint32_t> next(0);
+    std::mutex mutex;
+    QString error;
+    auto worker = [&]() {
+        for (uint32_t kbId = next++; kbId < m_iPopSize; kbId = next++) {
+            const QString fileName = dir.absoluteFilePath(QString("kb_%1.dat").arg(kbId));
+            QFile file(fileName);
+            QString e;
+            if (!file.open(QIODevice::ReadOnly)) {
+                e = QString("Unable to open %1").arg(fileName);
+            } else {
+                const QByteArray data = file.readAll();
+                ChromosomeView genes = m_population.current(kbId);
+                if (!parseChromosome(data.constData(), data.constData() + data.size(), genes)) {
+                    e = QString("Wrong values in %1").arg(fileName);
+                }
+            }
+            if (!e.isEmpty()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = e;
+                next = m_iPopSize; // stop the others
+                return;
             }
         }
+    };
+    const uint32_t workers = std::max(1u, std::min<uint32_t>(std::thread::hardware_concurrency(), m_iPopSize));
+    std::vector<std::thread> threads;
+    for (uint32_t w = 1; w < workers; ++w) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (size_t w = 0; w < threads.size(); ++w) {
+        threads[w].join();
+    }
+    if (!error.isEmpty()) {
+        qFatal("\n[FATAL] %s", qUtf8Printable(error));
+    }
 
-        if (!exists) {
-            ids.push_back(randId);
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        if (!m_controllers[kbId]->setChromosome(m_population.current(kbId))) {
+            qFatal("\n[FATAL] Something went wrong when loading the chromosome of robot %d: %s",
+                   kbId, qUtf8Printable(dir.absolutePath()));
         }
     }
+}
 
-    // get the fittest
-    float bestPerf = -1;
-    uint32_t bestPerfId = -1;
-    for (uint32_t i = 0; i < ids.size(); ++i) {
-        float perf = m_controllers[ids.at(i)]->getPerformance();
-        if (perf > bestPerf) {
-            bestPerf = perf;
-            bestPerfId = ids.at(i);
+void AbstractGALoopFunction::selectParents()
+{
+    KGA_PROFILE(PROFILE_SELECT);
+    m_operators.selectParents(m_fitness, m_parents);
+}
+
+void AbstractGALoopFunction::breed()
+{
+    KGA_PROFILE(PROFILE_BREED);
+    // mutated genes are drawn as by the controller of the first parent,
+    // but from the stream of the offspring
+    const GeneticOperators::RandGene randGene = [this](uint32_t parent, RandomStream& rng, uint8_t* gene) {
+        controllerOf(parent)->fillRandGene(gene, rng);
+    };
+    m_operators.breed(m_parents, m_population, randGene);
+
+    // offspring below the median (of the surrogate) are replaced by new ones
+    const uint32_t elitism = std::min(m_operators.elitism(), m_iPopSize);
+    for (uint32_t round = 0; round < m_iSurrogateScreening && elitism < m_iPopSize; ++round) {
+        evaluateSurrogate(true, m_surrogateFitness);
+
+        std::vector<float> offspring(m_surrogateFitness.begin() + elitism, m_surrogateFitness.end());
+        std::nth_element(offspring.begin(), offspring.begin() + offspring.size() / 2, offspring.end());
+        const float median = offspring[offspring.size() / 2];
+
+        m_operators.selectParents(m_fitness, m_parents);
+        for (uint32_t i = elitism; i < m_iPopSize; ++i) {
+            if (m_surrogateFitness[i] < median) {
+                m_operators.breedOffspring(i, m_parents, m_population, randGene);
+            }
         }
     }
-    return bestPerfId;
 }
 
-float AbstractGALoopFunction::getGlobalPerformance() const
+void AbstractGALoopFunction::initSurrogate()
 {
-    float ret = 0.f;
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        ret += m_controllers[kbId]->getPerformance();
+    // the robots run the controller set in the XML (id 'fcc') with its params
+    TConfigurationNode& controllers = GetNode(GetSimulator().GetConfigurationRoot(), "controllers");
+    TConfigurationNodeIterator it;
+    bool found = false;
+    for (it = it.begin(&controllers); it != it.end(); ++it) {
+        std::string id;
+        GetNodeAttributeOrDefault(*it, "id", id, std::string());
+        if (id == "fcc") {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        qFatal("\n[FATAL] The surrogate needs the controller 'fcc' in the XML file.");
+    }
+
+    QString error;
+    m_surrogate.setArena(m_arenaSideX, m_arenaSideY);
+    m_surrogate.setClock(CPhysicsEngine::GetSimulationClockTick(), GetSimulator().GetMaxSimulationClock());
+    if (!m_surrogate.init(it->Value(), GetNode(*it, "params"), m_iRobots, error)) {
+        qFatal("\n[FATAL] Unable to create the surrogate: %s", qUtf8Printable(error));
     }
-    return ret;
 }
 
-uint32_t AbstractGALoopFunction::getBestRobotId() const
+void AbstractGALoopFunction::evaluateSurrogate(bool nextGeneration, std::vector<float>& fitness)
 {
-    uint32_t bestId = -1;
-    float bestPerf = -1.f;
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        float perf = m_controllers[kbId]->getPerformance();
-        if (bestPerf < perf) {
-            bestPerf = perf;
-            bestId = kbId;
+    // same layout and groups as the simulation, new streams every generation
+    const UInt32 stream = m_iCurGeneration * m_batches.batches();
+    m_surrogateGenomes.resize(m_iRobots);
+    if (m_batches.identity()) {
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            m_surrogateGenomes[kbId] = nextGeneration ? m_population.next(kbId) : m_population.current(kbId);
         }
+        m_surrogate.evaluate(m_layout, m_surrogateGenomes, m_iBaseSeed, stream, fitness);
+        return;
+    }
+
+    m_batches.clearScores();
+    for (uint32_t b = 0; b < m_batches.batches(); ++b) {
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            const uint32_t g = m_batches.genome(b, kbId);
+            m_surrogateGenomes[kbId] = nextGeneration ? m_population.next(g) : m_population.current(g);
+        }
+        m_surrogate.evaluate(m_layout, m_surrogateGenomes, m_iBaseSeed, stream + b, m_surrogateBatch);
+        for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+            m_batches.score(b, kbId, m_surrogateBatch[kbId]);
+        }
+    }
+    m_batches.fitness(fitness);
+}
+
+void AbstractGALoopFunction::loadNextGeneration()
+{
+    // the robots just point to the new genes; nothing is copied
+    m_population.swap();
+    for (uint32_t kbId = 0; kbId < m_iRobots; ++kbId) {
+        m_controllers[kbId]->setChromosome(m_population.current(kbId));
     }
-    return bestId;
 }
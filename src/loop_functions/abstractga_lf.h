@@ -24,11 +24,24 @@
 #include <argos3/plugins/robots/kilobot/simulator/kilobot_entity.h>
 
 #include "controllers/abstractga_ctrl.h"
-
+#include "batch_plan.h"
+#include "checkpoint.h"
+#include "fitness_archive.h"
+#include "generation_driver.h"
+#include "generation_stats.h"
+#include "generation_writer.h"
+#include "genetic_operators.h"
+#include "island_model.h"
+#include "placement.h"
+#include "population.h"
+#include "population_archive.h"
+#include "race.h"
+#include "surrogate.h"
+#include "trial_runner.h"
+
+#include <QDir>
 #include <QString>
 
-typedef std::vector<Chromosome> Population;
-
 /**
  * @brief The AbstractGALoopFunction class
  * @author Marcos Cardinot <mcardinot@gmail.com>
@@ -42,6 +55,9 @@ public:
 
     virtual void Init(TConfigurationNode& t_node);
     virtual void Reset();
+    virtual void Destroy();
+    virtual void PostStep();
+    virtual bool IsExperimentFinished();
     virtual void PostExperiment();
 
 protected:
@@ -58,7 +74,8 @@ protected:
     };
 
     // stuff loaded from the xml script
-    size_t m_iPopSize;
+    size_t m_iPopSize; // number of genomes
+    size_t m_iRobots;  // number of simulated robots (group size)
     size_t m_iTournamentSize;
     size_t m_iMaxGenerations;
     float m_fMutationRate;
@@ -69,22 +86,119 @@ protected:
     SIMULATION_MODE m_eSimMode;
     uint32_t m_iCurGeneration;
     QString m_sRelativePath;
-    Population m_nextGeneration;
-
-    std::vector<CKilobotEntity*> m_entities;
-    std::vector<AbstractGACtrl*> m_controllers;
+    bool m_bBinaryOutput; // store generations in a binary archive
+    bool m_bTextOutput;   // export generations as text files (one per robot)
+    bool m_bProfileCSV;   // write the profiling report as csv
+    bool m_bProfileJSON;  // write the profiling report as json lines
+    bool m_bStatsCSV;     // write the statistics of each generation as csv
+    bool m_bStatsJSON;    // write the statistics of each generation as json lines
+    Population m_population; // current and next generations
+    std::vector<float> m_fitness; // performance of each robot
+    GenerationDriver m_driver;
+    TrialRunner m_trials;      // evaluates each generation in several trials
+    IslandModel m_islands;     // subpopulations evolving in parallel
+    bool m_bInTrial;           // true in the process running a trial
+    bool m_bEvolving;          // true once the driver runs the generations
+    GenerationWriter m_writer; // stores the results in background
+    ArchiveWriter m_archive;   // only used by the writer thread
+    GenerationStats m_stats;   // only used by the writer thread
+
+    std::vector<CKilobotEntity*> m_entities;     // one per robot
+    std::vector<AbstractGACtrl*> m_controllers;  // one per robot
+    BatchPlan m_batches; // which genome each robot gets in each run
+
+    // the controller drawing the random genes of a genome
+    inline AbstractGACtrl* controllerOf(uint32_t genome) const {
+        return m_controllers[genome % m_controllers.size()];
+    }
+
+    // copy the given genes into the current generation and bind them to the
+    // robot of the same id (if any); return false if chromosome is not suitable
+    bool loadChromosome(uint32_t kbId, const ChromosomeView& chromosome);
+
+    // directory of the text files of a generation (created on demand)
+    QString generationPath(uint32_t generation) const;
 
 private:
-    CRandom::CRNG* m_pcRNG;
-
-    virtual void loadExperiment() = 0;
-    virtual void flushGeneration() const = 0;
-
-    void prepareNextGeneration();
+    CRandom::CRNG* m_pcRNG;          // used by the genetic operators
+    CRandom::CRNG* m_pcPlacementRNG; // used to place the robots (reset every generation)
+    GeneticOperators m_operators;
+
+    Placement m_placement;
+    std::vector<Placement::Pose> m_layout; // pose of each robot
+    size_t m_iPlaced;     // robots [m_iPlaced, m_iRobots) overlap in the layout
+    std::vector<size_t> m_relocated; // robots moved away from the layout (it holds their new pose)
+    UInt32 m_iLayoutSeed; // seed of the layout used to create the robots
+    UInt32 m_iBaseSeed;   // the random streams of each generation derive from it
+
+    uint32_t m_iCheckpointInterval; // in generations (0 = never)
+    bool m_bResumed; // true if continuing an interrupted evolution
+
+    FitnessArchive m_fitnessArchive;   // fitness of the genomes seen so far
+    std::vector<uint64_t> m_genomeHashes; // hash of the genome of each robot
+    uint32_t m_iArchiveSamples;  // samples needed to skip an evaluation (0 = never)
+    float m_fArchiveTolerance;   // max standard error (relative to the mean) to skip it
+
+    KinematicSurrogate m_surrogate;  // cheap approximation of the simulation
+    uint32_t m_iSurrogateGenerations; // generations evaluated only by the surrogate
+    uint32_t m_iSurrogateScreening;   // screening rounds of the offspring (0 = none)
+    std::vector<ChromosomeView> m_surrogateGenomes;
+    std::vector<float> m_surrogateBatch;
+    std::vector<float> m_surrogateFitness;
+
+    Race m_race; // stops an evaluation once the ranking has settled
+    std::vector<float> m_racePerformance;
+
+    void createRobots();
+    void applyLayout();
+    void checkLayout();
+    // move the relocated robots back to where checkLayout() put them
+    void restoreLayout();
+    void moveRandomly(size_t id);
+
+    // replay a generation: a number, 'last' or 'best' (archive only)
+    void loadExperiment(QString generation);
+    void loadArchivedGeneration(const QString& fileName, const QString& generation);
+    void loadTextGeneration(QDir dir, const QString& generation);
+    // read the text of a chromosome (as written by flushGeneration()) into
+    // 'genes', whose layout is fixed; it is called from several threads
+    virtual bool parseChromosome(const char* begin, const char* end, ChromosomeView& genes) const = 0;
+    // export a generation as text files (called from the writer thread)
+    // return false and set the error message if something went wrong
+    virtual bool flushGeneration(const GenerationSnapshot& snapshot, QString& error) const = 0;
+    // add measures of the genotypes to the statistics (called from the writer thread)
+    virtual void genotypeStats(const GenerationSnapshot&, GenerationStats&) const {}
+
+    std::vector<uint32_t> m_parents; // two parents per offspring
+    std::vector<uint32_t> m_ranking; // ids sorted by fitness (best first)
+
+    void initPopulation();
+    void startIsland();
+    void reseed(uint32_t generation);
+    void saveCheckpoint(uint32_t generation);
+    void loadCheckpoint(const QString& fileName);
+    void migrate(uint32_t generation);
+    void gatherFitness();
+    // true if the run started by ARGoS is enough to evaluate the first
+    // generation, i.e., robot i runs genome i once and nothing else is involved
+    bool plainEvaluation() const;
+    // evaluate every genome of the current generation (in batches)
+    void evaluatePopulation(std::vector<float>& fitness);
+    // fitness of a robot at the end of the evaluation (projected if raced)
+    float performance(uint32_t kbId) const;
+    void initSurrogate();
+    void evaluateSurrogate(bool nextGeneration, std::vector<float>& fitness);
+    void hashGenomes();
+    bool reuseArchivedFitness();
+    void archiveFitness();
+    void recordGeneration();
+    void checkWriter() const;
+    void selectParents();
+    void breed();
     void loadNextGeneration();
-    float getGlobalPerformance() const;
-    uint32_t getBestRobotId() const;
-    uint32_t tournamentSelection() const;
+    void evaluate();
+    void evaluateGeneration();
+    void runTrial(uint32_t trial, std::vector<float>& fitness);
 };
 
 #endif // ABSTRACTGA_LOOPFUNCTION_H
@@ -0,0 +1,95 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batch_plan.h"
+
+#include <algorithm>
+#include <numeric>
+
+BatchPlan::BatchPlan()
+    : m_iPopSize(0)
+    , m_iGroupSize(0)
+    , m_iBatches(0)
+    , m_eGrouping(RANDOM)
+{
+}
+
+bool BatchPlan::parseGrouping(const std::string& name, Grouping& grouping)
+{
+    if (name == "random") {
+        grouping = RANDOM;
+    } else if (name == "clonal") {
+        grouping = CLONAL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void BatchPlan::setup(uint32_t popSize, uint32_t groupSize, Grouping grouping)
+{
+    m_iPopSize = popSize;
+    m_iGroupSize = groupSize;
+    m_eGrouping = grouping;
+    m_iBatches = grouping == CLONAL ? popSize : (popSize + groupSize - 1) / groupSize;
+    m_genomes.resize(m_iBatches * m_iGroupSize);
+    m_sum.assign(popSize, 0.0);
+    m_count.assign(popSize, 0);
+
+    if (grouping == CLONAL) {
+        for (uint32_t b = 0; b < m_iBatches; ++b) {
+            std::fill(m_genomes.begin() + b * m_iGroupSize, m_genomes.begin() + (b + 1) * m_iGroupSize, b);
+        }
+    } else {
+        // identity until plan() is called
+        for (uint32_t i = 0; i < m_genomes.size(); ++i) {
+            m_genomes[i] = i % popSize;
+        }
+    }
+}
+
+void BatchPlan::plan(CRandom::CRNG* rng)
+{
+    if (m_eGrouping == CLONAL || identity()) {
+        return;
+    }
+
+    // random permutation of the genomes (Fisher-Yates)
+    std::iota(m_genomes.begin(), m_genomes.begin() + m_iPopSize, 0);
+    for (uint32_t i = m_iPopSize - 1; i > 0; --i) {
+        std::swap(m_genomes[i], m_genomes[rng->Uniform(CRange<UInt32>(0, i + 1))]);
+    }
+    // fill the last batch
+    for (uint32_t i = m_iPopSize; i < m_genomes.size(); ++i) {
+        m_genomes[i] = rng->Uniform(CRange<UInt32>(0, m_iPopSize));
+    }
+}
+
+void BatchPlan::clearScores()
+{
+    std::fill(m_sum.begin(), m_sum.end(), 0.0);
+    std::fill(m_count.begin(), m_count.end(), 0);
+}
+
+void BatchPlan::fitness(std::vector<float>& fitness) const
+{
+    fitness.resize(m_iPopSize);
+    for (uint32_t g = 0; g < m_iPopSize; ++g) {
+        fitness[g] = m_count[g] ? m_sum[g] / m_count[g] : 0.f;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCH_PLAN_H
+#define BATCH_PLAN_H
+
+#include <argos3/core/utility/math/rng.h>
+
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+/**
+ * @brief The BatchPlan class
+ * Evaluation of a population of 'popSize' genomes with only 'groupSize'
+ * robots: the population is split in batches, and each batch is a run of
+ * the simulation in which every robot gets one of the genomes.
+ *  - RANDOM: random heterogeneous groups; each genome is in one batch (the
+ *    last batch is completed with random genomes, which are evaluated twice)
+ *  - CLONAL: one batch per genome, in which all robots share that genome
+ * The fitness of a genome is the mean performance of the robots which got it.
+ * With groupSize == popSize (random grouping), robot i simply gets genome i.
+ * @author KilobotGA contributors
+ */
+class BatchPlan
+{
+
+public:
+    enum Grouping {
+        RANDOM,
+        CLONAL
+    };
+
+    BatchPlan();
+
+    // 'random' or 'clonal'
+    static bool parseGrouping(const std::string& name, Grouping& grouping);
+
+    void setup(uint32_t popSize, uint32_t groupSize, Grouping grouping);
+
+    inline uint32_t groupSize() const { return m_iGroupSize; }
+    inline bool identity() const { return m_eGrouping == RANDOM && m_iGroupSize == m_iPopSize; }
+    inline uint32_t batches() const { return m_iBatches; }
+    // genome of a robot in the given batch
+    inline uint32_t genome(uint32_t batch, uint32_t robot) const {
+        return m_genomes[batch * m_iGroupSize + robot];
+    }
+
+    // draw new groups (it does nothing with clonal groups)
+    void plan(CRandom::CRNG* rng);
+
+    // fitness attribution
+    void clearScores();
+    inline void score(uint32_t batch, uint32_t robot, float performance) {
+        const uint32_t g = genome(batch, robot);
+        m_sum[g] += performance;
+        ++m_count[g];
+    }
+    void fitness(std::vector<float>& fitness) const;
+
+private:
+    uint32_t m_iPopSize;
+    uint32_t m_iGroupSize;
+    uint32_t m_iBatches;
+    Grouping m_eGrouping;
+    std::vector<uint32_t> m_genomes; // batches x groupSize
+    std::vector<double> m_sum;
+    std::vector<uint32_t> m_count;
+};
+
+#endif // BATCH_PLAN_H
@@ -0,0 +1,114 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "checkpoint.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+Checkpoint::Checkpoint()
+    : generation(0)
+    , seed(0)
+    , chromosomeLength(0)
+{
+    gene.scalar = GeneDescriptor::UINT8;
+    gene.count = 0;
+}
+
+bool Checkpoint::save(const QString& fileName, QString& error) const
+{
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(CheckpointHeader));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.generation = generation;
+    header.seed = seed;
+    header.popSize = popSize();
+    header.gene = gene;
+    header.chromosomeLength = chromosomeLength;
+    header.archiveEntries = archive.size();
+
+    std::vector<CheckpointArchiveEntry> entries(archive.size());
+    for (size_t i = 0; i < archive.size(); ++i) {
+        memset(&entries[i], 0, sizeof(CheckpointArchiveEntry));
+        entries[i].hash = archive[i].first;
+        entries[i].count = archive[i].second.count;
+        entries[i].mean = archive[i].second.mean;
+        entries[i].m2 = archive[i].second.m2;
+    }
+
+    // written to a temporary file, which replaces the old one on commit()
+    QSaveFile file(fileName);
+    const qint64 fitnessBytes = fitness.size() * sizeof(float);
+    const qint64 genesBytes = genes.size();
+    const qint64 archiveBytes = entries.size() * sizeof(CheckpointArchiveEntry);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write((const char*) &header, sizeof(header)) != sizeof(header)
+            || file.write((const char*) fitness.data(), fitnessBytes) != fitnessBytes
+            || file.write((const char*) genes.data(), genesBytes) != genesBytes
+            || file.write((const char*) entries.data(), archiveBytes) != archiveBytes
+            || !file.commit()) {
+        error = QString("Unable to write the checkpoint %1 (%2)").arg(fileName).arg(file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::load(const QString& fileName, QString& error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open the checkpoint %1 (%2)").arg(fileName).arg(file.errorString());
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (file.read((char*) &header, sizeof(header)) != sizeof(header)
+            || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0
+            || header.version != CHECKPOINT_VERSION) {
+        error = QString("%1 is not a valid checkpoint").arg(fileName);
+        return false;
+    }
+
+    generation = header.generation;
+    seed = header.seed;
+    gene = header.gene;
+    chromosomeLength = header.chromosomeLength;
+    fitness.resize(header.popSize);
+    genes.resize(header.popSize * chromosomeBytes());
+
+    const qint64 fitnessBytes = fitness.size() * sizeof(float);
+    const qint64 genesBytes = genes.size();
+    std::vector<CheckpointArchiveEntry> entries(header.archiveEntries);
+    const qint64 archiveBytes = entries.size() * sizeof(CheckpointArchiveEntry);
+    if (file.read((char*) fitness.data(), fitnessBytes) != fitnessBytes
+            || file.read((char*) genes.data(), genesBytes) != genesBytes
+            || file.read((char*) entries.data(), archiveBytes) != archiveBytes) {
+        error = QString("The checkpoint %1 is truncated").arg(fileName);
+        return false;
+    }
+
+    archive.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        archive[i].first = entries[i].hash;
+        archive[i].second.count = entries[i].count;
+        archive[i].second.mean = entries[i].mean;
+        archive[i].second.m2 = entries[i].m2;
+    }
+    return true;
+}
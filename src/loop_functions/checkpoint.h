@@ -0,0 +1,91 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "controllers/chromosome.h"
+#include "fitness_archive.h"
+
+#include <QString>
+
+/*
+ * Everything needed to continue an evolution after a generation was
+ * evaluated and recorded. All random streams are reseeded at the beginning
+ * of each generation (from 'seed' and the generation number), so they do
+ * not need to be stored.
+ *
+ *   CheckpointHeader
+ *   float fitness[popSize]
+ *   uint8_t genes[popSize][chromosomeLength * geneSize]
+ *   CheckpointArchiveEntry archive[archiveEntries] // fitness archive (most recently used first)
+ *
+ * Files are replaced atomically, i.e., a crash while saving a checkpoint
+ * leaves the previous one untouched.
+ */
+
+#define CHECKPOINT_FILENAME "checkpoint.kga"
+#define CHECKPOINT_MAGIC "KGA-CKP"
+#define CHECKPOINT_VERSION 2
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t generation; // last generation evaluated and recorded
+    uint32_t seed;       // base seed of the random streams
+    uint32_t popSize;
+    GeneDescriptor gene;
+    uint32_t chromosomeLength; // number of genes
+    uint32_t archiveEntries;
+};
+
+struct CheckpointArchiveEntry {
+    uint64_t hash;
+    uint32_t count;
+    uint32_t reserved;
+    double mean;
+    double m2;
+};
+
+/**
+ * @brief The Checkpoint struct
+ * State of an evolution between two generations.
+ * @author KilobotGA contributors
+ */
+struct Checkpoint {
+    uint32_t generation;
+    uint32_t seed;
+    GeneDescriptor gene;
+    uint32_t chromosomeLength;
+    std::vector<float> fitness;
+    std::vector<uint8_t> genes; // popSize chromosomes (no padding)
+    std::vector<FitnessArchive::Record> archive;
+
+    Checkpoint();
+
+    inline size_t popSize() const { return fitness.size(); }
+    inline size_t chromosomeBytes() const { return gene.geneSize() * chromosomeLength; }
+    inline const uint8_t* chromosome(size_t i) const { return &genes[i * chromosomeBytes()]; }
+    inline uint8_t* chromosome(size_t i) { return &genes[i * chromosomeBytes()]; }
+
+    // return false and set the error message if something went wrong
+    bool save(const QString& fileName, QString& error) const;
+    bool load(const QString& fileName, QString& error);
+};
+
+#endif // CHECKPOINT_H
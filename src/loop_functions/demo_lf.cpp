@@ -17,100 +17,124 @@
  */
 
 #include "demo_lf.h"
+#include "text_parser.h"
 
-#include <QDebug>
-#include <QDir>
 #include <QFile>
 #include <QTextStream>
 
+#include <algorithm>
+#include <cmath>
+
 DemoLF::DemoLF()
     : AbstractGALoopFunction()
 {
 }
 
-void DemoLF::flushGeneration() const
+bool DemoLF::flushGeneration(const GenerationSnapshot& snapshot, QString& error) const
 {
     if (m_sRelativePath.isEmpty()) {
-        qFatal("[FATAL] Unable to write! Directory was not defined!");
-        return;
+        error = "Unable to write! Directory was not defined!";
+        return false;
     }
 
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        QString path = QString("%1/%2/kb_%3.dat").arg(m_sRelativePath).arg(m_iCurGeneration).arg(kbId);
-        QFile file(path);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            qFatal("[FATAL] Unable to write in %s", qUtf8Printable(path));
+    const QString genPath = generationPath(snapshot.generation);
+    for (uint32_t kbId = 0; kbId < snapshot.size(); ++kbId) {
+        QString path = QString("%1/kb_%2.dat").arg(genPath).arg(kbId);
+        if (!writeChromosome(path, snapshot.chromosome(kbId), error)) {
+            return false;
         }
+    }
+    return true;
+}
 
-        QTextStream out(&file);
-        out.setRealNumberPrecision(SPEED_PRECISION);
-        Chromosome chromosome = m_controllers[kbId]->getChromosome();
-
-        for (uint32_t m = 0; m < chromosome.size(); ++m) {
-            MotorSpeed motorSpeed = chromosome[m].value<MotorSpeed>();
-            out << motorSpeed.left << "\t" << motorSpeed.right << "\n";
+void DemoLF::genotypeStats(const GenerationSnapshot& snapshot, GenerationStats& stats) const
+{
+    // genotypic diversity of the LUTs, from the variance of each motor speed
+    // across the population (a single pass over the genes)
+    const size_t popSize = snapshot.size();
+    std::vector<double> sum(2 * snapshot.length, 0.0);
+    std::vector<double> sumSq(2 * snapshot.length, 0.0);
+    for (uint32_t kbId = 0; kbId < popSize; ++kbId) {
+        const ChromosomeView c = snapshot.chromosome(kbId);
+        for (uint32_t i = 0; i < c.size(); ++i) {
+            const MotorSpeed& m = c.gene<MotorSpeed>(i);
+            sum[2 * i] += m.left;
+            sum[2 * i + 1] += m.right;
+            sumSq[2 * i] += m.left * m.left;
+            sumSq[2 * i + 1] += m.right * m.right;
         }
     }
+
+    double totalVar = 0, totalStd = 0;
+    for (size_t j = 0; popSize > 0 && j < sum.size(); ++j) {
+        const double mean = sum[j] / popSize;
+        const double var = std::max(0.0, sumSq[j] / popSize - mean * mean);
+        totalVar += var;
+        totalStd += std::sqrt(var);
+    }
+    // mean spread of a speed, and the rms distance between two LUTs
+    stats.add("gene_std", sum.empty() ? 0.0 : totalStd / sum.size());
+    stats.add("lut_distance", std::sqrt(2 * totalVar));
 }
 
-void DemoLF::loadExperiment()
+bool DemoLF::parseChromosome(const char* p, const char* end, ChromosomeView& genes) const
 {
-    QTextStream stream(stdin);
-    bool ok = false;
-    while (!ok) {
-        qDebug() << "\nWhich generation do you want to see? ";
-        m_iCurGeneration = stream.readLine().toInt(&ok);
+    // one gene per line, i.e., "left\tright"
+    for (uint32_t i = 0; i < genes.size(); ++i) {
+        MotorSpeed& m = genes.gene<MotorSpeed>(i);
+        if (!TextParser::parseFloat(p, end, m.left) || !TextParser::parseFloat(p, end, m.right)
+                || !TextParser::endOfLine(p, end)) {
+            return false;
+        }
     }
-
-    QFileInfo path(QString::fromStdString(GetSimulator().GetExperimentFileName()));
-    QDir dir = path.absoluteDir();
-    if (!dir.cd(QString::number(m_iCurGeneration))) {
-        qFatal("\n[FATAL] There is no data for this generation!\n%s\n", qUtf8Printable(dir.absolutePath()));
+    // only blank lines may follow
+    while (p < end) {
+        if (!TextParser::endOfLine(p, end)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    // also check population size (number of files)
-    dir.setNameFilters(QStringList("kb*.dat"));
-    dir.setFilter(QDir::Files | QDir::NoSymLinks);
-    if ((uint32_t) dir.entryInfoList().size() != m_iPopSize) {
-        qFatal("\n[FATAL] The folder for this generation should have %ld files!\n%s\n",
-               m_iPopSize, qUtf8Printable(dir.absolutePath()));
+bool DemoLF::writeChromosome(const QString& path, const ChromosomeView& chromosome, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        error = QString("Unable to write in %1").arg(path);
+        return false;
     }
 
-    // all is fine, let's load the LUTs of each kilobot
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        QString fn = QString("kb_%1.dat").arg(kbId);
-        loadLUTMotor(kbId, dir.absoluteFilePath(fn));
+    QTextStream out(&file);
+    out.setRealNumberPrecision(SPEED_PRECISION);
+    for (uint32_t m = 0; m < chromosome.size(); ++m) {
+        const MotorSpeed& motorSpeed = chromosome.gene<MotorSpeed>(m);
+        out << motorSpeed.left << "\t" << motorSpeed.right << "\n";
     }
+    return true;
 }
 
-void DemoLF::loadLUTMotor(const uint32_t kbId, const QString& absoluteFilePath) const
+bool DemoLF::readChromosome(const QString& path, std::vector<MotorSpeed>& lut, QString& error)
 {
-    // read file
-    QFile file(absoluteFilePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qFatal("[FATAL] Unable to open %s", qUtf8Printable(absoluteFilePath));
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open %1").arg(path);
+        return false;
     }
 
-    // load the lookup table
-    Chromosome chromosome;
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QStringList values = in.readLine().split("\t");
-        bool ok1, ok2;
+    lut.clear();
+    const QByteArray data = file.readAll();
+    const char* p = data.constData();
+    const char* end = p + data.size();
+    while (p < end) {
         MotorSpeed m;
-        m.left = QString(values.at(0)).toDouble(&ok1);
-        m.right = QString(values.at(1)).toDouble(&ok2);
-        if (!ok1 || !ok2 || values.size() != 2) {
-            qFatal("\n[FATAL] Wrong values in %s", qUtf8Printable(absoluteFilePath));
+        if (!TextParser::parseFloat(p, end, m.left) || !TextParser::parseFloat(p, end, m.right)
+                || !TextParser::endOfLine(p, end)) {
+            error = QString("Wrong values in %1").arg(path);
+            return false;
         }
-        chromosome.push_back(QVariant::fromValue(m));
-    }
-
-    // all is fine, setting the lookup table
-    if (!m_controllers[kbId]->setChromosome(chromosome)) {
-        // something went wrong; print filepath
-        qFatal("\n[FATAL] Something went wrong when loading the chromosome values: %s", qUtf8Printable(absoluteFilePath));
+        lut.push_back(m);
     }
+    return true;
 }
 
 REGISTER_LOOP_FUNCTIONS(DemoLF, "demo_loop_functions")
@@ -33,10 +33,15 @@ public:
     DemoLF();
     virtual ~DemoLF() {}
 
+    // text format of a chromosome: one gene per line, i.e., "left\tright"
+    // return false and set the error message if something went wrong
+    static bool writeChromosome(const QString& path, const ChromosomeView& chromosome, QString& error);
+    static bool readChromosome(const QString& path, std::vector<MotorSpeed>& lut, QString& error);
+
 private:
-    virtual void flushGeneration() const;
-    virtual void loadExperiment();
-    void loadLUTMotor(const uint32_t kbId, const QString& absoluteFilePath) const;
+    virtual bool flushGeneration(const GenerationSnapshot& snapshot, QString& error) const;
+    virtual void genotypeStats(const GenerationSnapshot& snapshot, GenerationStats& stats) const;
+    virtual bool parseChromosome(const char* begin, const char* end, ChromosomeView& genes) const;
 };
 
 #endif // DEMO_LOOP_FUNCTIONS_H
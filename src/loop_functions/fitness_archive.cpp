@@ -0,0 +1,120 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fitness_archive.h"
+
+#include <cmath>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+double FitnessArchive::Entry::stdError() const
+{
+    return count > 0 ? std::sqrt(variance() / count) : 0.0;
+}
+
+FitnessArchive::FitnessArchive()
+    : m_iCapacity(0)
+{
+}
+
+void FitnessArchive::setCapacity(size_t capacity)
+{
+    m_iCapacity = capacity;
+    while (m_index.size() > m_iCapacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+    m_index.reserve(m_iCapacity);
+}
+
+void FitnessArchive::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+uint64_t FitnessArchive::hash(const ChromosomeView& chromosome)
+{
+    uint64_t h = FNV_OFFSET;
+    const uint8_t* data = chromosome.data();
+    for (size_t i = 0; i < chromosome.byteSize(); ++i) {
+        h ^= data[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+void FitnessArchive::add(uint64_t hash, float fitness)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    std::unordered_map<uint64_t, Entries::iterator>::iterator it = m_index.find(hash);
+    if (it == m_index.end()) {
+        // make room for the new genome
+        if (m_index.size() >= m_iCapacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        Entry e = { 0, 0.0, 0.0 };
+        m_entries.push_front(std::make_pair(hash, e));
+        it = m_index.insert(std::make_pair(hash, m_entries.begin())).first;
+    } else {
+        touch(it->second);
+    }
+
+    Entry& e = it->second->second;
+    ++e.count;
+    const double delta = fitness - e.mean;
+    e.mean += delta / e.count;
+    e.m2 += delta * (fitness - e.mean);
+}
+
+const FitnessArchive::Entry* FitnessArchive::find(uint64_t hash)
+{
+    std::unordered_map<uint64_t, Entries::iterator>::iterator it = m_index.find(hash);
+    if (it == m_index.end()) {
+        return NULL;
+    }
+    touch(it->second);
+    return &it->second->second;
+}
+
+void FitnessArchive::records(std::vector<Record>& records) const
+{
+    records.assign(m_entries.begin(), m_entries.end());
+}
+
+void FitnessArchive::restore(const std::vector<Record>& records)
+{
+    clear();
+    for (size_t i = 0; i < records.size() && m_index.size() < m_iCapacity; ++i) {
+        if (m_index.count(records[i].first) == 0) {
+            m_entries.push_back(records[i]);
+            m_index.insert(std::make_pair(records[i].first, --m_entries.end()));
+        }
+    }
+}
+
+void FitnessArchive::touch(Entries::iterator it)
+{
+    // move to the front; the iterators are still valid
+    m_entries.splice(m_entries.begin(), m_entries, it);
+}
@@ -0,0 +1,85 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FITNESS_ARCHIVE_H
+#define FITNESS_ARCHIVE_H
+
+#include "controllers/chromosome.h"
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The FitnessArchive class
+ * Remembers the fitness of the genomes evaluated so far, keyed by a 64-bit
+ * hash of their genes. Each entry keeps the number of samples and their
+ * running mean and variance (Welford). It holds at most 'capacity' genomes;
+ * the least recently used one is dropped to make room for a new one.
+ * @author KilobotGA contributors
+ */
+class FitnessArchive
+{
+
+public:
+    struct Entry {
+        uint32_t count;
+        double mean;
+        double m2; // sum of squared deviations from the mean
+
+        inline double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+        // standard error of the mean
+        double stdError() const;
+    };
+
+    typedef std::pair<uint64_t, Entry> Record; // hash, entry
+
+    FitnessArchive();
+
+    // 0 disables the archive
+    void setCapacity(size_t capacity);
+    inline size_t capacity() const { return m_iCapacity; }
+    inline bool enabled() const { return m_iCapacity > 0; }
+    inline size_t size() const { return m_index.size(); }
+    void clear();
+
+    // FNV-1a of the genes
+    static uint64_t hash(const ChromosomeView& chromosome);
+
+    // add a fitness sample of a genome
+    void add(uint64_t hash, float fitness);
+    // NULL if the genome is unknown
+    const Entry* find(uint64_t hash);
+
+    // all entries, most recently used first (e.g., for a checkpoint)
+    void records(std::vector<Record>& records) const;
+    // replace the entries by the given ones (most recently used first)
+    void restore(const std::vector<Record>& records);
+
+private:
+    typedef std::list<Record> Entries;
+
+    size_t m_iCapacity;
+    Entries m_entries; // most recently used first
+    std::unordered_map<uint64_t, Entries::iterator> m_index;
+
+    void touch(Entries::iterator it);
+};
+
+#endif // FITNESS_ARCHIVE_H
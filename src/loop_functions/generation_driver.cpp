@@ -0,0 +1,94 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "generation_driver.h"
+
+#include <chrono>
+
+GenerationDriver::GenerationDriver()
+{
+    for (int p = 0; p < NUM_PHASES; ++p) {
+        m_lastTime[p] = 0.0;
+        m_totalTime[p] = 0.0;
+    }
+}
+
+void GenerationDriver::setStep(Phase phase, Step step)
+{
+    m_steps[phase] = step;
+}
+
+void GenerationDriver::addHook(Phase phase, Hook hook)
+{
+    m_hooks[phase].push_back(hook);
+}
+
+void GenerationDriver::run(uint32_t& generation, uint32_t maxGenerations, Start start)
+{
+    if (start == FROM_EVALUATE) {
+        runPhase(EVALUATE, generation);
+    }
+
+    bool record = start != FROM_SELECT;
+    while (true) {
+        if (record) {
+            runPhase(RECORD, generation);
+        }
+        record = true;
+
+        ++generation;
+        if (generation >= maxGenerations) {
+            break;
+        }
+
+        runPhase(SELECT, generation);
+        runPhase(BREED, generation);
+        runPhase(RESET, generation);
+        runPhase(EVALUATE, generation);
+    }
+}
+
+void GenerationDriver::runPhase(Phase phase, uint32_t generation)
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+
+    if (m_steps[phase]) {
+        m_steps[phase]();
+    }
+
+    const double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    m_lastTime[phase] = secs;
+    m_totalTime[phase] += secs;
+
+    for (size_t h = 0; h < m_hooks[phase].size(); ++h) {
+        m_hooks[phase][h](generation);
+    }
+}
+
+const char* GenerationDriver::phaseName(Phase phase)
+{
+    switch (phase) {
+    case RECORD: return "record";
+    case SELECT: return "select";
+    case BREED: return "breed";
+    case RESET: return "reset";
+    case EVALUATE: return "evaluate";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GENERATION_DRIVER_H
+#define GENERATION_DRIVER_H
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief The GenerationDriver class
+ * Runs the evolution as a plain loop (constant stack depth), one iteration
+ * per generation:
+ *   RECORD -> SELECT -> BREED -> RESET -> EVALUATE -> RECORD -> ...
+ * The work of each phase is given by the loop function (see setStep()) and
+ * extra per-generation work can be scheduled with addHook(). The driver also
+ * measures the wall time spent in each phase.
+ * @author KilobotGA contributors
+ */
+class GenerationDriver
+{
+
+public:
+    enum Phase {
+        RECORD,   // store/log the results of the evaluated generation
+        SELECT,   // choose the parents of the next generation
+        BREED,    // crossover and mutation
+        RESET,    // reset the simulation and load the new generation
+        EVALUATE, // run the simulation
+        NUM_PHASES
+    };
+
+    // where run() starts in the loop
+    enum Start {
+        FROM_EVALUATE, // the current generation has not been evaluated yet
+        FROM_RECORD,   // the current generation has just been evaluated
+        FROM_SELECT    // the current generation has already been recorded
+    };
+
+    // called with the current generation number
+    typedef std::function<void(uint32_t)> Hook;
+    typedef std::function<void()> Step;
+
+    GenerationDriver();
+
+    void setStep(Phase phase, Step step);
+
+    // hooks are called right after the phase, in the order they were added
+    void addHook(Phase phase, Hook hook);
+
+    // run from the current 'generation' up to 'maxGenerations'
+    void run(uint32_t& generation, uint32_t maxGenerations, Start start = FROM_RECORD);
+
+    // wall time (in seconds) spent in the last execution of a phase
+    inline double lastTime(Phase phase) const { return m_lastTime[phase]; }
+    // wall time (in seconds) spent in a phase since the beginning
+    inline double totalTime(Phase phase) const { return m_totalTime[phase]; }
+
+    static const char* phaseName(Phase phase);
+
+private:
+    Step m_steps[NUM_PHASES];
+    std::vector<Hook> m_hooks[NUM_PHASES];
+    double m_lastTime[NUM_PHASES];
+    double m_totalTime[NUM_PHASES];
+
+    void runPhase(Phase phase, uint32_t generation);
+};
+
+#endif // GENERATION_DRIVER_H
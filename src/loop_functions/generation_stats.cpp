@@ -0,0 +1,164 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "generation_stats.h"
+#include "controllers/record_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+GenerationStats::GenerationStats()
+    : m_bCSVHeader(false)
+    , m_iGeneration(0)
+    , m_iSize(0)
+    , m_fMin(0)
+    , m_fMax(0)
+    , m_fMean(0)
+    , m_fStdDev(0)
+    , m_iBest(0)
+{
+    m_quartiles[0] = m_quartiles[1] = m_quartiles[2] = 0;
+}
+
+bool GenerationStats::open(const std::string& basePath, bool csv, bool json, int64_t lastGeneration,
+                           std::string& error)
+{
+    const std::ios::openmode mode = std::ios::out | (lastGeneration >= 0 ? std::ios::app : std::ios::trunc);
+
+    if (csv) {
+        const std::string fileName = basePath + ".csv";
+        const long kept = lastGeneration >= 0 ? truncateRecords(fileName, (uint32_t) lastGeneration) : 0;
+        m_csv.open(fileName.c_str(), mode);
+        if (kept < 0 || !m_csv) {
+            error = "Unable to write in " + fileName;
+            return false;
+        }
+        // the header is only needed in an empty file
+        m_bCSVHeader = kept == 0;
+    }
+
+    if (json) {
+        const std::string fileName = basePath + ".json";
+        const long kept = lastGeneration >= 0 ? truncateRecords(fileName, (uint32_t) lastGeneration) : 0;
+        m_json.open(fileName.c_str(), mode);
+        if (kept < 0 || !m_json) {
+            error = "Unable to write in " + fileName;
+            return false;
+        }
+    }
+    return true;
+}
+
+void GenerationStats::close()
+{
+    if (m_csv.is_open()) m_csv.close();
+    if (m_json.is_open()) m_json.close();
+}
+
+void GenerationStats::summarize(const GenerationSnapshot& snapshot)
+{
+    const std::vector<float>& fitness = snapshot.fitness;
+    m_iGeneration = snapshot.generation;
+    m_iSize = fitness.size();
+    m_extra.clear();
+
+    // min, max, best and Welford's mean/variance in one pass
+    m_fMin = std::numeric_limits<float>::max();
+    m_fMax = -std::numeric_limits<float>::max();
+    m_fMean = 0;
+    double m2 = 0;
+    m_iBest = 0;
+    for (uint32_t i = 0; i < m_iSize; ++i) {
+        const float f = fitness[i];
+        if (f < m_fMin) m_fMin = f;
+        if (f > m_fMax) {
+            m_fMax = f;
+            m_iBest = i;
+        }
+        const double delta = f - m_fMean;
+        m_fMean += delta / (i + 1);
+        m2 += delta * (f - m_fMean);
+    }
+    m_fStdDev = m_iSize > 1 ? std::sqrt(m2 / (m_iSize - 1)) : 0.0;
+
+    if (m_iSize == 0) {
+        m_fMin = m_fMax = 0;
+        m_quartiles[0] = m_quartiles[1] = m_quartiles[2] = 0;
+        return;
+    }
+
+    // nearest-rank quartiles; each selection only looks at the right part
+    m_sorted.assign(fitness.begin(), fitness.end());
+    std::vector<float>::iterator from = m_sorted.begin();
+    for (int q = 0; q < 3; ++q) {
+        std::vector<float>::iterator nth = m_sorted.begin() + (q + 1) * (m_iSize - 1) / 4;
+        std::nth_element(from, nth, m_sorted.end());
+        m_quartiles[q] = *nth;
+        from = nth;
+    }
+}
+
+void GenerationStats::add(const char* name, double value)
+{
+    m_extra.push_back(std::make_pair(name, value));
+}
+
+bool GenerationStats::write(std::string& error)
+{
+    if (m_csv.is_open()) {
+        if (m_bCSVHeader) {
+            m_csv << "generation,size,min,q25,median,q75,max,mean,std,best";
+            for (size_t i = 0; i < m_extra.size(); ++i) {
+                m_csv << "," << m_extra[i].first;
+            }
+            m_csv << "\n";
+            m_bCSVHeader = false;
+        }
+        m_csv << m_iGeneration << "," << m_iSize << "," << m_fMin << "," << m_quartiles[0]
+              << "," << m_quartiles[1] << "," << m_quartiles[2] << "," << m_fMax
+              << "," << m_fMean << "," << m_fStdDev << "," << m_iBest;
+        for (size_t i = 0; i < m_extra.size(); ++i) {
+            m_csv << "," << m_extra[i].second;
+        }
+        m_csv << "\n";
+        m_csv.flush();
+        if (!m_csv) {
+            error = "Unable to write the statistics (csv)";
+            return false;
+        }
+    }
+
+    if (m_json.is_open()) {
+        m_json << "{\"generation\":" << m_iGeneration << ",\"size\":" << m_iSize
+               << ",\"min\":" << m_fMin << ",\"q25\":" << m_quartiles[0]
+               << ",\"median\":" << m_quartiles[1] << ",\"q75\":" << m_quartiles[2]
+               << ",\"max\":" << m_fMax << ",\"mean\":" << m_fMean
+               << ",\"std\":" << m_fStdDev << ",\"best\":" << m_iBest;
+        for (size_t i = 0; i < m_extra.size(); ++i) {
+            m_json << ",\"" << m_extra[i].first << "\":" << m_extra[i].second;
+        }
+        m_json << "}\n";
+        m_json.flush();
+        if (!m_json) {
+            error = "Unable to write the statistics (json)";
+            return false;
+        }
+    }
+    return true;
+}
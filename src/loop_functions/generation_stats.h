@@ -0,0 +1,79 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GENERATION_STATS_H
+#define GENERATION_STATS_H
+
+#include "generation_writer.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The GenerationStats class
+ * Summary of the fitness of each generation (min, mean, max, standard
+ * deviation, quartiles and best id), plus any genotype measure given by the
+ * loop function, e.g., strategy frequencies or diversity. Each generation is
+ * appended to 'stats.csv' and/or 'stats.json' (json lines) and flushed right
+ * away, so the files can be followed while the evolution runs.
+ * It is meant to be used from the writer thread only.
+ * @author KilobotGA contributors
+ */
+class GenerationStats
+{
+
+public:
+    GenerationStats();
+
+    // when resuming after 'lastGeneration' (-1 = new run), the lines of the
+    // later generations are dropped and new lines are appended to the files
+    bool open(const std::string& basePath, bool csv, bool json, int64_t lastGeneration, std::string& error);
+    void close();
+    inline bool isOpen() const { return m_csv.is_open() || m_json.is_open(); }
+
+    // single pass over the fitness (the quartiles are found in linear time);
+    // the genotype measures must be set with add() before calling write()
+    void summarize(const GenerationSnapshot& snapshot);
+    void add(const char* name, double value);
+    bool write(std::string& error);
+
+    inline float min() const { return m_fMin; }
+    inline float max() const { return m_fMax; }
+    inline double mean() const { return m_fMean; }
+    inline double stdDev() const { return m_fStdDev; }
+    inline uint32_t best() const { return m_iBest; }
+
+private:
+    std::ofstream m_csv;
+    std::ofstream m_json;
+    bool m_bCSVHeader; // the csv header is written along with the first line
+
+    uint32_t m_iGeneration;
+    uint32_t m_iSize;
+    float m_fMin;
+    float m_fMax;
+    double m_fMean;
+    double m_fStdDev;
+    float m_quartiles[3];
+    uint32_t m_iBest;
+    std::vector<float> m_sorted; // scratch buffer for the quartiles
+    std::vector<std::pair<const char*, double> > m_extra;
+};
+
+#endif // GENERATION_STATS_H
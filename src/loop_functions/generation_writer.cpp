@@ -0,0 +1,135 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "generation_writer.h"
+
+GenerationWriter::GenerationWriter(size_t capacity)
+    : m_pool(capacity > 0 ? capacity : 1)
+    , m_iBusy(0)
+    , m_bStop(false)
+{
+    for (size_t i = 0; i < m_pool.size(); ++i) {
+        m_free.push_back(&m_pool[i]);
+    }
+}
+
+GenerationWriter::~GenerationWriter()
+{
+    stop();
+}
+
+void GenerationWriter::addSink(Sink sink)
+{
+    m_sinks.push_back(sink);
+}
+
+void GenerationWriter::start()
+{
+    if (m_thread.joinable()) {
+        return;
+    }
+    m_bStop = false;
+    m_thread = std::thread(&GenerationWriter::run, this);
+}
+
+void GenerationWriter::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStop = true;
+    }
+    m_cvQueue.notify_all();
+    m_thread.join();
+}
+
+GenerationSnapshot* GenerationWriter::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvFree.wait(lock, [this]() { return !m_free.empty(); });
+    GenerationSnapshot* snapshot = m_free.back();
+    m_free.pop_back();
+    return snapshot;
+}
+
+void GenerationWriter::submit(GenerationSnapshot* snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(snapshot);
+    }
+    m_cvQueue.notify_one();
+}
+
+void GenerationWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_cvFree.wait(lock, [this]() { return m_queue.empty() && m_iBusy == 0; });
+}
+
+bool GenerationWriter::hasError() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_sError.isEmpty();
+}
+
+QString GenerationWriter::errorString() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sError;
+}
+
+void GenerationWriter::run()
+{
+    while (true) {
+        GenerationSnapshot* snapshot;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvQueue.wait(lock, [this]() { return m_bStop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return; // stop requested and nothing left to write
+            }
+            snapshot = m_queue.front();
+            m_queue.pop_front();
+            ++m_iBusy;
+        }
+
+        // the snapshot belongs to this thread until it's released
+        QString error;
+        for (size_t s = 0; s < m_sinks.size(); ++s) {
+            if (!m_sinks[s](*snapshot, error)) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!error.isEmpty() && m_sError.isEmpty()) {
+                m_sError = error; // keep the first error only
+            }
+            --m_iBusy;
+            m_free.push_back(snapshot);
+        }
+        m_cvFree.notify_all();
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GENERATION_WRITER_H
+#define GENERATION_WRITER_H
+
+#include "controllers/chromosome.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <QString>
+
+/**
+ * @brief The GenerationSnapshot struct
+ * An immutable copy of the results of a generation.
+ */
+struct GenerationSnapshot {
+    uint32_t generation;
+    std::vector<float> fitness;
+    std::vector<uint8_t> genes; // fitness.size() chromosomes of 'stride' bytes
+    std::vector<uint32_t> parents; // two per chromosome (empty if unknown)
+    size_t stride;
+    size_t geneSize;
+    size_t length;
+
+    inline size_t size() const { return fitness.size(); }
+    inline const ChromosomeView chromosome(size_t i) const {
+        return ChromosomeView(const_cast<uint8_t*>(&genes[i * stride]), geneSize, length);
+    }
+};
+
+/**
+ * @brief The GenerationWriter class
+ * Stores the results of each generation in a background thread, so the
+ * simulation can go ahead while the files are written.
+ * Snapshots are taken from a fixed-size pool; when all of them are waiting to
+ * be written, acquire() blocks until one is free (bounded queue).
+ * Errors never stop the writer thread; they are kept and must be checked by
+ * the caller with hasError().
+ * @author KilobotGA contributors
+ */
+class GenerationWriter
+{
+
+public:
+    // return false and set the error message if the snapshot could not be stored
+    typedef std::function<bool(const GenerationSnapshot&, QString&)> Sink;
+
+    explicit GenerationWriter(size_t capacity = 4);
+    ~GenerationWriter();
+
+    // sinks are called in order for each snapshot (must be added before start())
+    void addSink(Sink sink);
+
+    void start();
+    // write everything which is still queued and stop the thread
+    void stop();
+
+    // get a free snapshot (blocks while the queue is full)
+    GenerationSnapshot* acquire();
+    // queue a snapshot taken with acquire()
+    void submit(GenerationSnapshot* snapshot);
+
+    // barrier: block until all submitted snapshots are written
+    void flush();
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    std::vector<Sink> m_sinks;
+    std::vector<GenerationSnapshot> m_pool;
+    std::vector<GenerationSnapshot*> m_free;
+    std::deque<GenerationSnapshot*> m_queue;
+    size_t m_iBusy; // number of snapshots being written
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cvQueue; // something was queued (or stop)
+    std::condition_variable m_cvFree;  // a snapshot was released
+    bool m_bStop;
+    QString m_sError;
+
+    void run();
+};
+
+#endif // GENERATION_WRITER_H
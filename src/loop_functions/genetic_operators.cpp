@@ -0,0 +1,436 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "genetic_operators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// attempts to draw a second parent different from the first one
+#define MAX_PAIR_ATTEMPTS 16
+// genes (in bytes) a thread must breed to be worth starting
+#define MIN_BYTES_PER_THREAD 65536
+
+// number of genes kept before the next mutation, for log(1 - rate) < 0;
+// the gaps between two mutations follow a geometric distribution
+static inline size_t mutationGap(RandomStream& rng, double logKeep, size_t limit)
+{
+    const double u = (rng.next() + 0.5) * (1.0 / 4294967296.0); // (0, 1)
+    const double gap = std::floor(std::log(u) / logKeep);
+    return gap < limit ? (size_t) gap : limit;
+}
+
+void AliasTable::build(const std::vector<float>& weights)
+{
+    const uint32_t n = weights.size();
+    m_probability.resize(n);
+    m_alias.resize(n);
+    m_scaled.resize(n);
+    m_small.clear();
+    m_large.clear();
+
+    double sum = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        sum += std::max(weights[i], 0.f);
+    }
+
+    // Vose's algorithm: each column holds (up to) two outcomes
+    for (uint32_t i = 0; i < n; ++i) {
+        m_scaled[i] = sum > 0 ? std::max(weights[i], 0.f) * n / sum : 1.f;
+        if (m_scaled[i] < 1.f) {
+            m_small.push_back(i);
+        } else {
+            m_large.push_back(i);
+        }
+    }
+
+    while (!m_small.empty() && !m_large.empty()) {
+        const uint32_t s = m_small.back();
+        const uint32_t l = m_large.back();
+        m_small.pop_back();
+        m_probability[s] = m_scaled[s];
+        m_alias[s] = l;
+        m_scaled[l] = (m_scaled[l] + m_scaled[s]) - 1.f;
+        if (m_scaled[l] < 1.f) {
+            m_large.pop_back();
+            m_small.push_back(l);
+        }
+    }
+
+    // what is left is (up to rounding errors) a full column
+    for (uint32_t i = 0; i < m_large.size(); ++i) {
+        m_probability[m_large[i]] = 1.f;
+        m_alias[m_large[i]] = m_large[i];
+    }
+    for (uint32_t i = 0; i < m_small.size(); ++i) {
+        m_probability[m_small[i]] = 1.f;
+        m_alias[m_small[i]] = m_small[i];
+    }
+}
+
+uint32_t AliasTable::sample(CRandom::CRNG* rng) const
+{
+    const uint32_t column = rng->Uniform(CRange<UInt32>(0, m_probability.size()));
+    return rng->Uniform(CRange<Real>(0, 1)) < m_probability[column] ? column : m_alias[column];
+}
+
+GeneticOperators::GeneticOperators()
+    : m_pcRNG(NULL)
+    , m_eSelection(TOURNAMENT)
+    , m_iTournamentSize(2)
+    , m_iElitism(1)
+    , m_fMutationRate(0.f)
+    , m_fCrossoverRate(0.f)
+    , m_iThreads(1)
+    , m_iSeed(0)
+    , m_iGeneration(0)
+    , m_iRound(0)
+    , m_iNextSample(0)
+{
+}
+
+bool GeneticOperators::parseSelection(const std::string& name, Selection& selection)
+{
+    if (name == "tournament") {
+        selection = TOURNAMENT;
+    } else if (name == "rank") {
+        selection = RANK;
+    } else if (name == "roulette") {
+        selection = ROULETTE;
+    } else if (name == "sus") {
+        selection = SUS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void GeneticOperators::setSeed(UInt32 seed, UInt32 generation)
+{
+    m_iSeed = seed;
+    m_iGeneration = generation;
+    m_iRound = 0;
+    // tournaments start from the identity permutation, as after a resume
+    std::iota(m_permutation.begin(), m_permutation.end(), 0);
+}
+
+void GeneticOperators::selectParents(const std::vector<float>& fitness, std::vector<uint32_t>& parents)
+{
+    const size_t popSize = fitness.size();
+    const size_t elitism = std::min(m_iElitism, popSize);
+    parents.resize(2 * popSize);
+    ++m_iRound;
+
+    // elitism: keep the best robots
+    best(fitness, elitism, m_elite);
+    for (uint32_t i = 0; i < elitism; ++i) {
+        parents[2*i] = parents[2*i+1] = m_elite[i];
+    }
+
+    prepareSelection(fitness, 2 * (popSize - elitism));
+
+    for (uint32_t i = elitism; i < popSize; ++i) {
+        // select two individuals
+        uint32_t id1 = select(fitness);
+        uint32_t id2 = select(fitness);
+        // make sure they are different (sus pairs are already fixed);
+        // give up when the fitness leaves no choice
+        if (m_eSelection != SUS) {
+            for (int a = 0; id1 == id2 && a < MAX_PAIR_ATTEMPTS; ++a) {
+                id2 = select(fitness);
+            }
+        }
+
+        parents[2*i] = id1;
+        parents[2*i+1] = id2;
+    }
+}
+
+void GeneticOperators::prepareSelection(const std::vector<float>& fitness, size_t picks)
+{
+    switch (m_eSelection) {
+    case TOURNAMENT:
+        break;
+    case RANK: {
+        const uint32_t popSize = fitness.size();
+        best(fitness, popSize, m_ranking);
+        m_weights.resize(popSize);
+        for (uint32_t r = 0; r < popSize; ++r) {
+            m_weights[m_ranking[r]] = popSize - r;
+        }
+        m_alias.build(m_weights);
+        break;
+    }
+    case ROULETTE:
+        m_alias.build(fitness);
+        break;
+    case SUS:
+        stochasticUniversalSampling(fitness, picks);
+        break;
+    }
+}
+
+uint32_t GeneticOperators::select(const std::vector<float>& fitness)
+{
+    switch (m_eSelection) {
+    case RANK:
+    case ROULETTE:
+        return m_alias.sample(m_pcRNG);
+    case SUS:
+        return m_sampled[m_iNextSample++];
+    case TOURNAMENT:
+    default:
+        return tournamentSelection(fitness);
+    }
+}
+
+void GeneticOperators::stochasticUniversalSampling(const std::vector<float>& fitness, size_t picks)
+{
+    const uint32_t popSize = fitness.size();
+    m_sampled.clear();
+    m_iNextSample = 0;
+    if (picks == 0 || popSize == 0) {
+        return;
+    }
+
+    double sum = 0;
+    for (uint32_t i = 0; i < popSize; ++i) {
+        sum += std::max(fitness[i], 0.f);
+    }
+    const bool uniform = sum <= 0;
+    if (uniform) {
+        sum = popSize;
+    }
+
+    // 'picks' equally spaced pointers over the cumulative fitness
+    const double step = sum / picks;
+    double pointer = m_pcRNG->Uniform(CRange<Real>(0, step));
+    double cumulative = 0;
+    for (uint32_t i = 0; i < popSize && m_sampled.size() < picks; ++i) {
+        cumulative += uniform ? 1.f : std::max(fitness[i], 0.f);
+        while (pointer < cumulative && m_sampled.size() < picks) {
+            m_sampled.push_back(i);
+            pointer += step;
+        }
+    }
+    // rounding errors might leave the last pointers out
+    while (m_sampled.size() < picks) {
+        m_sampled.push_back(m_sampled.back());
+    }
+
+    // the picks are sorted by id, so shuffle them to form the pairs
+    for (uint32_t i = picks - 1; i > 0; --i) {
+        std::swap(m_sampled[i], m_sampled[m_pcRNG->Uniform(CRange<UInt32>(0, i + 1))]);
+    }
+
+    // make sure both parents of an offspring are different
+    for (uint32_t i = 0; i + 1 < picks; i += 2) {
+        for (int a = 0; m_sampled[i] == m_sampled[i+1] && a < MAX_PAIR_ATTEMPTS; ++a) {
+            std::swap(m_sampled[i+1], m_sampled[m_pcRNG->Uniform(CRange<UInt32>(0, picks))]);
+        }
+    }
+}
+
+void GeneticOperators::breed(const std::vector<uint32_t>& parents, Population& population,
+                             const RandGene& randGene)
+{
+    const uint32_t popSize = population.size();
+    const uint32_t elitism = std::min<size_t>(m_iElitism, popSize);
+
+    // elitism: the best chromosomes are kept unchanged
+    for (uint32_t i = 0; i < elitism; ++i) {
+        population.next(i).copyFrom(population.current(parents[2*i]));
+    }
+
+    // the offspring are split in contiguous chunks, one per thread;
+    // small generations are bred by the calling thread only
+    const uint32_t offspring = popSize - elitism;
+    const uint64_t bytes = (uint64_t) offspring * population.chromosomeLength() * population.geneSize();
+    uint64_t workers = m_iThreads > 0 ? m_iThreads : std::thread::hardware_concurrency();
+    workers = std::max<uint64_t>(1, std::min<uint64_t>(workers, bytes / MIN_BYTES_PER_THREAD));
+    if (m_scratch.size() < workers) {
+        m_scratch.resize(workers);
+    }
+
+    auto worker = [&](uint32_t w) {
+        const uint32_t begin = elitism + (uint64_t) offspring * w / workers;
+        const uint32_t end = elitism + (uint64_t) offspring * (w + 1) / workers;
+        for (uint32_t i = begin; i < end; ++i) {
+            breedOffspring(i, parents, population, randGene, m_scratch[w]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t w = 1; w < workers; ++w) {
+        threads.push_back(std::thread(worker, w));
+    }
+    worker(0);
+    for (size_t w = 0; w < threads.size(); ++w) {
+        threads[w].join();
+    }
+}
+
+void GeneticOperators::breedOffspring(uint32_t i, const std::vector<uint32_t>& parents, Population& population,
+                                      const RandGene& randGene)
+{
+    if (m_scratch.empty()) {
+        m_scratch.resize(1);
+    }
+    breedOffspring(i, parents, population, randGene, m_scratch[0]);
+}
+
+void GeneticOperators::breedOffspring(uint32_t i, const std::vector<uint32_t>& parents, Population& population,
+                                      const RandGene& randGene, Scratch& scratch) const
+{
+    const uint32_t id1 = parents[2*i];
+    const ChromosomeView chromosome1 = population.current(id1);
+    const ChromosomeView chromosome2 = population.current(parents[2*i+1]);
+    ChromosomeView children = population.next(i);
+    const size_t length = children.size();
+    const size_t geneSize = children.geneSize();
+
+    RandomStream rng;
+    rng.setKey(m_iSeed, OFFSPRING_STREAM | i);
+    rng.setCounter(m_iGeneration, m_iRound);
+
+    // crossover: a gene comes from the second parent when its draw is below
+    // the threshold; the draws become a byte mask to blend both parents
+    if (m_fCrossoverRate >= 1.f) {
+        children.copyFrom(chromosome2);
+    } else if (m_fCrossoverRate > 0.f) {
+        const uint32_t threshold = (uint32_t) (m_fCrossoverRate * 4294967296.0);
+        scratch.draws.resize(length);
+        scratch.mask.resize(children.byteSize());
+        rng.fill(scratch.draws.data(), length);
+        const uint32_t* draws = scratch.draws.data();
+        uint8_t* mask = scratch.mask.data();
+        if (geneSize == 1) {
+            for (size_t g = 0; g < length; ++g) {
+                mask[g] = draws[g] < threshold ? 0xFF : 0;
+            }
+        } else {
+            for (size_t g = 0; g < length; ++g) {
+                memset(mask + g * geneSize, draws[g] < threshold ? 0xFF : 0, geneSize);
+            }
+        }
+        blend(children.data(), chromosome1.data(), chromosome2.data(), mask, children.byteSize());
+    } else {
+        children.copyFrom(chromosome1);
+    }
+
+    // mutation: jump straight to the next mutated gene, so it costs one
+    // draw per mutation instead of one per gene
+    if (m_fMutationRate >= 1.f) {
+        for (size_t g = 0; g < length; ++g) {
+            randGene(id1, rng, children.at(g));
+        }
+    } else if (m_fMutationRate > 0.f) {
+        const double logKeep = std::log(1.0 - m_fMutationRate);
+        for (size_t g = mutationGap(rng, logKeep, length); g < length;
+             g += 1 + mutationGap(rng, logKeep, length)) {
+            randGene(id1, rng, children.at(g));
+        }
+    }
+}
+
+void GeneticOperators::blend(uint8_t* out, const uint8_t* a, const uint8_t* b, const uint8_t* mask, size_t bytes)
+{
+    size_t k = 0;
+#if defined(__AVX2__)
+    for (; k + 32 <= bytes; k += 32) {
+        const __m256i m = _mm256_loadu_si256((const __m256i*) (mask + k));
+        const __m256i x = _mm256_loadu_si256((const __m256i*) (a + k));
+        const __m256i y = _mm256_loadu_si256((const __m256i*) (b + k));
+        _mm256_storeu_si256((__m256i*) (out + k), _mm256_blendv_epi8(x, y, m));
+    }
+#elif defined(__SSE2__)
+    for (; k + 16 <= bytes; k += 16) {
+        const __m128i m = _mm_loadu_si128((const __m128i*) (mask + k));
+        const __m128i x = _mm_loadu_si128((const __m128i*) (a + k));
+        const __m128i y = _mm_loadu_si128((const __m128i*) (b + k));
+        _mm_storeu_si128((__m128i*) (out + k), _mm_or_si128(_mm_andnot_si128(m, x), _mm_and_si128(m, y)));
+    }
+#endif
+    // eight bytes at a time
+    for (; k + 8 <= bytes; k += 8) {
+        uint64_t m, x, y;
+        memcpy(&m, mask + k, 8);
+        memcpy(&x, a + k, 8);
+        memcpy(&y, b + k, 8);
+        x = (x & ~m) | (y & m);
+        memcpy(out + k, &x, 8);
+    }
+    for (; k < bytes; ++k) {
+        out[k] = (a[k] & ~mask[k]) | (b[k] & mask[k]);
+    }
+}
+
+uint32_t GeneticOperators::tournamentSelection(const std::vector<float>& fitness)
+{
+    const uint32_t popSize = fitness.size();
+    if (m_permutation.size() != popSize) {
+        m_permutation.resize(popSize);
+        std::iota(m_permutation.begin(), m_permutation.end(), 0);
+    }
+
+    // partial Fisher-Yates: the first 'size' ids of the permutation are
+    // distinct random ids, and it is still a permutation afterwards
+    const uint32_t size = std::min<size_t>(m_iTournamentSize, popSize);
+    float bestPerf = 0.f;
+    uint32_t bestPerfId = -1;
+    for (uint32_t i = 0; i < size; ++i) {
+        std::swap(m_permutation[i], m_permutation[m_pcRNG->Uniform(CRange<UInt32>(i, popSize))]);
+        const uint32_t id = m_permutation[i];
+        // get the fittest; the first candidate is the starting point, so
+        // negative fitness (e.g. PD payoffs) is handled
+        if (i == 0 || fitness[id] > bestPerf) {
+            bestPerf = fitness[id];
+            bestPerfId = id;
+        }
+    }
+    return bestPerfId;
+}
+
+void GeneticOperators::best(const std::vector<float>& fitness, size_t k, std::vector<uint32_t>& ids) const
+{
+    // ties are broken by the lowest id
+    ids.resize(fitness.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    k = std::min(k, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&fitness](uint32_t a, uint32_t b) {
+        return fitness[a] > fitness[b] || (fitness[a] == fitness[b] && a < b);
+    });
+    ids.resize(k);
+}
+
+float GeneticOperators::total(const std::vector<float>& fitness)
+{
+    float ret = 0.f;
+    for (uint32_t id = 0; id < fitness.size(); ++id) {
+        ret += fitness[id];
+    }
+    return ret;
+}
@@ -0,0 +1,160 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GENETIC_OPERATORS_H
+#define GENETIC_OPERATORS_H
+
+#include <argos3/core/utility/math/rng.h>
+
+#include "controllers/random_stream.h"
+#include "population.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+// robot part of the key of the offspring streams
+// (the robots use the keys below it)
+#define OFFSPRING_STREAM 0x80000000
+
+/**
+ * @brief The AliasTable class
+ * Walker's alias method: after an O(n) setup, draws an index with probability
+ * proportional to its weight in O(1), whatever the number of weights.
+ * @author KilobotGA contributors
+ */
+class AliasTable
+{
+
+public:
+    // negative weights count as zero; if all of them are zero, it is uniform
+    void build(const std::vector<float>& weights);
+    uint32_t sample(CRandom::CRNG* rng) const;
+
+private:
+    std::vector<float> m_probability;
+    std::vector<uint32_t> m_alias;
+    // scratch buffers of build()
+    std::vector<uint32_t> m_small;
+    std::vector<uint32_t> m_large;
+    std::vector<float> m_scaled;
+};
+
+/**
+ * @brief The GeneticOperators class
+ * Selection, crossover and mutation. It only deals with the fitness values
+ * and the population buffer, so it does not need a running simulation.
+ * Each offspring is bred from its own random stream, keyed by its id; so
+ * the offspring can be split among threads and the next generation does
+ * not depend on the number of threads.
+ * @author KilobotGA contributors
+ */
+class GeneticOperators
+{
+
+public:
+    enum Selection {
+        TOURNAMENT, // fittest of 'tournamentSize' distinct individuals
+        RANK,       // linear ranking (the best is 'popSize' times as likely as the worst)
+        ROULETTE,   // fitness proportionate
+        SUS         // stochastic universal sampling (fitness proportionate, low variance)
+    };
+
+    // write a random gene at the given address (for an offspring of 'parent'),
+    // drawn from the given stream; it is called from several threads
+    typedef std::function<void(uint32_t parent, RandomStream& rng, uint8_t* gene)> RandGene;
+
+    GeneticOperators();
+
+    // 'tournament', 'rank', 'roulette' or 'sus'
+    static bool parseSelection(const std::string& name, Selection& selection);
+
+    inline void setRNG(CRandom::CRNG* rng) { m_pcRNG = rng; }
+    inline void setSelection(Selection selection) { m_eSelection = selection; }
+    inline void setTournamentSize(size_t size) { m_iTournamentSize = size; }
+    inline void setElitism(size_t elitism) { m_iElitism = elitism; }
+    inline size_t elitism() const { return m_iElitism; }
+    inline void setMutationRate(float rate) { m_fMutationRate = rate; }
+    inline void setCrossoverRate(float rate) { m_fCrossoverRate = rate; }
+    // number of threads used to breed (0 = one per core)
+    inline void setThreads(uint32_t threads) { m_iThreads = threads; }
+    // key of the offspring streams of a generation; it also resets the state
+    // kept by the selection, so a generation only depends on (seed, generation)
+    void setSeed(UInt32 seed, UInt32 generation);
+
+    // choose two parents for each offspring;
+    // elitism: the first 'elitism' offspring are copies of the best individuals.
+    // the offspring of these parents get new streams
+    void selectParents(const std::vector<float>& fitness, std::vector<uint32_t>& parents);
+
+    // breed the next generation of the population from the selected parents
+    void breed(const std::vector<uint32_t>& parents, Population& population,
+               const RandGene& randGene);
+    // breed (again) the i-th offspring of the next generation
+    void breedOffspring(uint32_t i, const std::vector<uint32_t>& parents, Population& population,
+                        const RandGene& randGene);
+
+    // the fittest of 'tournamentSize' distinct random individuals
+    uint32_t tournamentSelection(const std::vector<float>& fitness);
+
+    // ids of the 'k' fittest individuals (best first)
+    void best(const std::vector<float>& fitness, size_t k, std::vector<uint32_t>& ids) const;
+
+    static float total(const std::vector<float>& fitness);
+
+private:
+    CRandom::CRNG* m_pcRNG;
+    Selection m_eSelection;
+    size_t m_iTournamentSize;
+    size_t m_iElitism;
+    float m_fMutationRate;
+    float m_fCrossoverRate;
+    uint32_t m_iThreads;
+    UInt32 m_iSeed;
+    UInt32 m_iGeneration;
+    UInt32 m_iRound; // number of selections in this generation
+
+    // scratch buffers of a breeding thread
+    struct Scratch {
+        std::vector<uint32_t> draws;
+        std::vector<uint8_t> mask;
+    };
+    std::vector<Scratch> m_scratch; // one per thread
+
+    // per-generation state of the selection
+    AliasTable m_alias;
+    std::vector<uint32_t> m_permutation; // tournament: partial Fisher-Yates
+    std::vector<uint32_t> m_ranking;     // rank: ids sorted by fitness
+    std::vector<uint32_t> m_elite;
+    std::vector<float> m_weights;
+    std::vector<uint32_t> m_sampled;     // sus: all picks of a generation
+    size_t m_iNextSample;
+
+    void prepareSelection(const std::vector<float>& fitness, size_t picks);
+    uint32_t select(const std::vector<float>& fitness);
+    void stochasticUniversalSampling(const std::vector<float>& fitness, size_t picks);
+
+    void breedOffspring(uint32_t i, const std::vector<uint32_t>& parents, Population& population,
+                        const RandGene& randGene, Scratch& scratch) const;
+    // out = mask ? b : a, byte by byte (16 or 32 bytes at a time with SSE2 or AVX2)
+    static void blend(uint8_t* out, const uint8_t* a, const uint8_t* b, const uint8_t* mask, size_t bytes);
+};
+
+#endif // GENETIC_OPERATORS_H
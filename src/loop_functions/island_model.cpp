@@ -0,0 +1,217 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "island_model.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the queues are shared by several processes, so their atomics
+// must not fall back to a (process-local) lock
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared queues need lock-free atomics");
+
+#define CACHE_LINE 64
+
+/**
+ * Header of a queue; slots follow it. Indices grow forever and wrap around
+ * the capacity, so head - tail is the number of migrants in the queue. The
+ * capacity is a power of two, which keeps the slots in order when the
+ * indices overflow.
+ * Head and tail live in different cache lines to avoid false sharing.
+ */
+struct IslandModel::Queue {
+    alignas(CACHE_LINE) std::atomic<uint32_t> head; // written by the producer
+    alignas(CACHE_LINE) std::atomic<uint32_t> tail; // written by the consumer
+    alignas(CACHE_LINE) uint8_t slots[1];
+
+    inline uint8_t* slot(uint32_t index, size_t capacity, size_t slotSize) {
+        return slots + (index % capacity) * slotSize;
+    }
+};
+
+IslandModel::IslandModel()
+    : m_iIslands(1)
+    , m_iInterval(10)
+    , m_iMigrants(1)
+    , m_eTopology(RING)
+    , m_iIsland(0)
+    , m_iChromosomeBytes(0)
+    , m_iSlotSize(0)
+    , m_iCapacity(0)
+    , m_iQueueSize(0)
+    , m_shared(NULL)
+    , m_iSharedSize(0)
+{
+}
+
+IslandModel::~IslandModel()
+{
+    if (m_shared) {
+        munmap(m_shared, m_iSharedSize);
+    }
+}
+
+bool IslandModel::parseTopology(const std::string& name, Topology& topology)
+{
+    if (name == "ring") {
+        topology = RING;
+    } else if (name == "full") {
+        topology = FULL;
+    } else if (name == "random") {
+        topology = RANDOM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool IslandModel::start(size_t chromosomeBytes, QString& error)
+{
+    if (m_iIslands < 2) {
+        return true;
+    }
+
+    // room for a few migrations, in case the destination is slower
+    m_iChromosomeBytes = chromosomeBytes;
+    m_iSlotSize = (sizeof(float) + chromosomeBytes + 7) & ~size_t(7);
+    m_iCapacity = 1;
+    while (m_iCapacity < 4 * (size_t) (m_iMigrants > 0 ? m_iMigrants : 1)) {
+        m_iCapacity *= 2;
+    }
+    m_iQueueSize = offsetof(Queue, slots) + m_iCapacity * m_iSlotSize;
+    m_iQueueSize = (m_iQueueSize + CACHE_LINE - 1) & ~size_t(CACHE_LINE - 1);
+    m_iSharedSize = m_iIslands * m_iIslands * m_iQueueSize;
+
+    // shared by all islands (i.e., inherited by the forked processes)
+    void* shared = mmap(NULL, m_iSharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        error = QString("Unable to allocate the migration queues: %1").arg(strerror(errno));
+        return false;
+    }
+    m_shared = static_cast<uint8_t*>(shared);
+    for (uint32_t src = 0; src < m_iIslands; ++src) {
+        for (uint32_t dst = 0; dst < m_iIslands; ++dst) {
+            Queue* q = new (m_shared + (src * m_iIslands + dst) * m_iQueueSize) Queue;
+            q->head.store(0, std::memory_order_relaxed);
+            q->tail.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (uint32_t island = 1; island < m_iIslands; ++island) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            error = QString("Unable to start island %1: %2").arg(island).arg(strerror(errno));
+            return false;
+        }
+        if (pid == 0) {
+            // child: this is the new island
+            m_iIsland = island;
+            m_children.clear();
+            return true;
+        }
+        m_children.push_back(pid);
+    }
+    return true;
+}
+
+bool IslandModel::wait(QString& error)
+{
+    bool ok = true;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        int status = 0;
+        pid_t r;
+        do {
+            r = waitpid(m_children[i], &status, 0);
+        } while (r < 0 && errno == EINTR);
+
+        if (r < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            error = QString("Island %1 did not finish properly").arg(i + 1);
+            ok = false;
+        }
+    }
+    m_children.clear();
+    return ok;
+}
+
+void IslandModel::destinations(CRandom::CRNG* rng, std::vector<uint32_t>& islands) const
+{
+    islands.clear();
+    if (m_iIslands < 2) {
+        return;
+    }
+
+    switch (m_eTopology) {
+    case RING:
+        islands.push_back((m_iIsland + 1) % m_iIslands);
+        break;
+    case FULL:
+        for (uint32_t i = 0; i < m_iIslands; ++i) {
+            if (i != m_iIsland) islands.push_back(i);
+        }
+        break;
+    case RANDOM: {
+        // any island but this one
+        uint32_t i = rng->Uniform(CRange<UInt32>(0, m_iIslands - 1));
+        islands.push_back(i < m_iIsland ? i : i + 1);
+        break;
+    }
+    }
+}
+
+IslandModel::Queue* IslandModel::queue(uint32_t source, uint32_t destination) const
+{
+    return reinterpret_cast<Queue*>(m_shared + (source * m_iIslands + destination) * m_iQueueSize);
+}
+
+bool IslandModel::send(uint32_t destination, float fitness, const uint8_t* genes)
+{
+    Queue* q = queue(m_iIsland, destination);
+    const uint32_t head = q->head.load(std::memory_order_relaxed);
+    if (head - q->tail.load(std::memory_order_acquire) >= m_iCapacity) {
+        return false; // full
+    }
+
+    uint8_t* slot = q->slot(head, m_iCapacity, m_iSlotSize);
+    memcpy(slot, &fitness, sizeof(float));
+    memcpy(slot + sizeof(float), genes, m_iChromosomeBytes);
+    // publish the slot
+    q->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool IslandModel::receive(uint32_t source, float& fitness, uint8_t* genes)
+{
+    Queue* q = queue(source, m_iIsland);
+    const uint32_t tail = q->tail.load(std::memory_order_relaxed);
+    if (tail == q->head.load(std::memory_order_acquire)) {
+        return false; // empty
+    }
+
+    const uint8_t* slot = q->slot(tail, m_iCapacity, m_iSlotSize);
+    memcpy(&fitness, slot, sizeof(float));
+    memcpy(genes, slot + sizeof(float), m_iChromosomeBytes);
+    // give the slot back
+    q->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
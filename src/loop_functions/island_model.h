@@ -0,0 +1,119 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include <argos3/core/utility/math/rng.h>
+
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include <QString>
+
+using namespace argos;
+
+/**
+ * @brief The IslandModel class
+ * Splits the evolution in several islands, i.e., independent subpopulations
+ * evolving in their own process (ARGoS allows only one simulator per
+ * process). Every 'interval' generations each island sends copies of its best
+ * individuals (migrants) to its neighbours in the topology.
+ *
+ * Migrants travel through lock-free single-producer/single-consumer queues
+ * (one per pair of islands) in memory shared by all processes. Islands never
+ * wait on one another: a full queue drops the migrant and an empty queue
+ * simply means that no migrant has arrived yet. So the generation in which
+ * a migrant arrives depends on timing: runs with several islands cannot be
+ * reproduced exactly, and resuming them is approximate (the migrants still
+ * in the queues are lost).
+ * @author KilobotGA contributors
+ */
+class IslandModel
+{
+
+public:
+    enum Topology {
+        RING,   // island i sends to island i+1
+        FULL,   // every island sends to all the others
+        RANDOM  // every island sends to a random island each time
+    };
+
+    IslandModel();
+    ~IslandModel();
+
+    // 'ring', 'full' or 'random'
+    static bool parseTopology(const std::string& name, Topology& topology);
+
+    inline void setIslands(uint32_t islands) { m_iIslands = islands > 0 ? islands : 1; }
+    inline void setInterval(uint32_t interval) { m_iInterval = interval > 0 ? interval : 1; }
+    inline void setMigrants(uint32_t migrants) { m_iMigrants = migrants; }
+    inline void setTopology(Topology topology) { m_eTopology = topology; }
+
+    inline uint32_t islands() const { return m_iIslands; }
+    inline uint32_t interval() const { return m_iInterval; }
+    inline uint32_t migrants() const { return m_iMigrants; }
+    // island of the calling process
+    inline uint32_t island() const { return m_iIsland; }
+
+    // true if migrants should be exchanged after this generation
+    inline bool migrationDue(uint32_t generation) const {
+        return m_iIslands > 1 && m_iMigrants > 0 && (generation + 1) % m_iInterval == 0;
+    }
+
+    // allocate the shared queues and fork one process per extra island;
+    // it returns in every island (the calling process is island 0)
+    // 'chromosomeBytes' is the size of the genes of a migrant
+    bool start(size_t chromosomeBytes, QString& error);
+
+    // in island 0, wait for the other islands to finish
+    // return false and set the error message if any of them failed
+    bool wait(QString& error);
+
+    // islands receiving the migrants of this island (this time)
+    void destinations(CRandom::CRNG* rng, std::vector<uint32_t>& islands) const;
+
+    // non-blocking; return false if the queue is full (migrant dropped)
+    bool send(uint32_t destination, float fitness, const uint8_t* genes);
+    // non-blocking; return false if there is no migrant from 'source'
+    bool receive(uint32_t source, float& fitness, uint8_t* genes);
+
+private:
+    struct Queue;
+
+    uint32_t m_iIslands;
+    uint32_t m_iInterval;
+    uint32_t m_iMigrants;
+    Topology m_eTopology;
+    uint32_t m_iIsland;
+
+    size_t m_iChromosomeBytes;
+    size_t m_iSlotSize;  // bytes of a migrant (fitness + genes)
+    size_t m_iCapacity;  // migrants per queue (a power of two)
+    size_t m_iQueueSize; // bytes of a queue (header + slots)
+    uint8_t* m_shared;   // islands x islands queues
+    size_t m_iSharedSize;
+    std::vector<pid_t> m_children;
+
+    // queue from 'source' to 'destination'
+    Queue* queue(uint32_t source, uint32_t destination) const;
+};
+
+#endif // ISLAND_MODEL_H
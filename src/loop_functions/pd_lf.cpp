@@ -17,9 +17,8 @@
  */
 
 #include "pd_lf.h"
+#include "text_parser.h"
 
-#include <QDebug>
-#include <QDir>
 #include <QFile>
 #include <QTextStream>
 
@@ -28,73 +27,103 @@ PDLF::PDLF()
 {
 }
 
-void PDLF::flushGeneration() const
+bool PDLF::flushGeneration(const GenerationSnapshot& snapshot, QString& error) const
 {
     if (m_sRelativePath.isEmpty()) {
-        qFatal("[FATAL] Unable to write! Directory was not defined!");
-        return;
+        error = "Unable to write! Directory was not defined!";
+        return false;
     }
 
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        QString path = QString("%1/%2/kb_%3.dat").arg(m_sRelativePath).arg(m_iCurGeneration).arg(kbId);
-        QFile file(path);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            qFatal("[FATAL] Unable to write in %s", qUtf8Printable(path));
+    const QString genPath = generationPath(snapshot.generation);
+    for (uint32_t kbId = 0; kbId < snapshot.size(); ++kbId) {
+        QString path = QString("%1/kb_%2.dat").arg(genPath).arg(kbId);
+        if (!writeChromosome(path, snapshot.chromosome(kbId), error)) {
+            return false;
         }
-        // save the pure strategy, i.e., 0 (C), 1(D) or 2 (A)
-        QTextStream out(&file);
-        out << m_controllers[kbId]->getChromosome()[0].toInt();
     }
+    return true;
 }
 
-void PDLF::loadExperiment()
+void PDLF::genotypeStats(const GenerationSnapshot& snapshot, GenerationStats& stats) const
 {
-    QTextStream stream(stdin);
-    bool ok = false;
-    while (!ok) {
-        qDebug() << "\nWhich generation do you want to see? ";
-        m_iCurGeneration = stream.readLine().toInt(&ok);
+    // frequency of each pure strategy, i.e., 0 (C), 1 (D) or 2 (A)
+    uint32_t count[3] = { 0, 0, 0 };
+    uint32_t total = 0;
+    for (uint32_t kbId = 0; kbId < snapshot.size(); ++kbId) {
+        const ChromosomeView c = snapshot.chromosome(kbId);
+        for (uint32_t i = 0; i < c.size(); ++i) {
+            const uint8_t strategy = c.gene<uint8_t>(i);
+            if (strategy < 3) {
+                ++count[strategy];
+            }
+            ++total;
+        }
     }
+    const double n = total ? total : 1;
+    stats.add("cooperators", count[0] / n);
+    stats.add("defectors", count[1] / n);
+    stats.add("abstainers", count[2] / n);
+}
 
-    QFileInfo path(QString::fromStdString(GetSimulator().GetExperimentFileName()));
-    QDir dir = path.absoluteDir();
-    if (!dir.cd(QString::number(m_iCurGeneration))) {
-        qFatal("\n[FATAL] There is no data for this generation!\n%s\n", qUtf8Printable(dir.absolutePath()));
+bool PDLF::parseChromosome(const char* p, const char* end, ChromosomeView& genes) const
+{
+    // one strategy per line
+    for (uint32_t i = 0; i < genes.size(); ++i) {
+        uint32_t strategy;
+        if (!TextParser::parseUInt(p, end, strategy) || strategy > UINT8_MAX
+                || !TextParser::endOfLine(p, end)) {
+            return false;
+        }
+        genes.gene<uint8_t>(i) = (uint8_t) strategy;
+    }
+    // only blank lines may follow
+    while (p < end) {
+        if (!TextParser::endOfLine(p, end)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    // also check population size (number of files)
-    dir.setNameFilters(QStringList("kb*.dat"));
-    dir.setFilter(QDir::Files | QDir::NoSymLinks);
-    if ((uint32_t) dir.entryInfoList().size() != m_iPopSize) {
-        qFatal("\n[FATAL] The folder for this generation should have %ld files!\n%s\n",
-               m_iPopSize, qUtf8Printable(dir.absolutePath()));
+bool PDLF::writeChromosome(const QString& path, const ChromosomeView& chromosome, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        error = QString("Unable to write in %1").arg(path);
+        return false;
     }
 
-    // all is fine, let's load the chromosomes of each kilobot
-    for (uint32_t kbId = 0; kbId < m_iPopSize; ++kbId) {
-        QString absoluteFilePath = dir.absoluteFilePath(QString("kb_%1.dat").arg(kbId));
-        QFile file(absoluteFilePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qFatal("[FATAL] Unable to open %s", qUtf8Printable(absoluteFilePath));
-        }
+    // save the pure strategy, i.e., 0 (C), 1(D) or 2 (A)
+    QTextStream out(&file);
+    for (uint32_t i = 0; i < chromosome.size(); ++i) {
+        if (i > 0) out << "\n";
+        out << (int) chromosome.gene<uint8_t>(i);
+    }
+    return true;
+}
 
-        Chromosome chromosome;
-        QTextStream in(&file);
-        while (!in.atEnd()) {
-            bool ok;
-            int strategy = in.readLine().toInt(&ok);
-            if (!ok) {
-                qFatal("\n[FATAL] Wrong value in %s", qUtf8Printable(absoluteFilePath));
-            }
-            chromosome.push_back(strategy);
-        }
+bool PDLF::readChromosome(const QString& path, std::vector<uint8_t>& strategies, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open %1").arg(path);
+        return false;
+    }
 
-        // all is fine, setting the chromosome (pure game strategy)
-        if (!m_controllers[kbId]->setChromosome(chromosome)) {
-            // something went wrong; print filepath
-            qFatal("\n[FATAL] Something went wrong when loading the chromosome values: %s", qUtf8Printable(absoluteFilePath));
+    strategies.clear();
+    const QByteArray data = file.readAll();
+    const char* p = data.constData();
+    const char* end = p + data.size();
+    while (p < end) {
+        uint32_t strategy;
+        if (!TextParser::parseUInt(p, end, strategy) || strategy > UINT8_MAX
+                || !TextParser::endOfLine(p, end)) {
+            error = QString("Wrong value in %1").arg(path);
+            return false;
         }
+        strategies.push_back((uint8_t) strategy);
     }
+    return true;
 }
 
 REGISTER_LOOP_FUNCTIONS(PDLF, "pd_loop_functions")
@@ -33,11 +33,17 @@ public:
     PDLF();
     virtual ~PDLF() {}
 
+    // text format of a chromosome: one strategy per line
+    // return false and set the error message if something went wrong
+    static bool writeChromosome(const QString& path, const ChromosomeView& chromosome, QString& error);
+    static bool readChromosome(const QString& path, std::vector<uint8_t>& strategies, QString& error);
+
 private:
     CRandom::CRNG* m_pcRNG;
 
-    virtual void flushGeneration() const;
-    virtual void loadExperiment();
+    virtual bool flushGeneration(const GenerationSnapshot& snapshot, QString& error) const;
+    virtual void genotypeStats(const GenerationSnapshot& snapshot, GenerationStats& stats) const;
+    virtual bool parseChromosome(const char* begin, const char* end, ChromosomeView& genes) const;
 };
 
 #endif // PD_LOOP_FUNCTIONS_H
@@ -0,0 +1,262 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "placement.h"
+
+#include <algorithm>
+#include <cmath>
+
+// number of random positions tried for each robot (uniform)
+#define MAX_UNIFORM_TRIALS 100
+// number of candidates around each active sample (Poisson-disk)
+#define POISSON_CANDIDATES 30
+
+// a side shrunk by the radius of a robot at both ends
+// (the middle point if the robot does not fit)
+static CRange<Real> inset(const CRange<Real>& side)
+{
+    if (side.GetSpan() <= 2 * KILOBOT_RADIUS) {
+        const Real middle = (side.GetMin() + side.GetMax()) / 2;
+        return CRange<Real>(middle, middle);
+    }
+    return CRange<Real>(side.GetMin() + KILOBOT_RADIUS, side.GetMax() - KILOBOT_RADIUS);
+}
+
+Placement::Placement()
+    : m_eMethod(UNIFORM)
+    , m_fMinDistance(0.035)
+    , m_fCellSize(0)
+    , m_iCols(0)
+    , m_iRows(0)
+{
+    setArena(CRange<Real>(-0.5, 0.5), CRange<Real>(-0.5, 0.5));
+}
+
+void Placement::setArena(const CRange<Real>& x, const CRange<Real>& y)
+{
+    m_arenaX = inset(x);
+    m_arenaY = inset(y);
+}
+
+bool Placement::parseMethod(const std::string& name, Method& method)
+{
+    if (name == "uniform") {
+        method = UNIFORM;
+    } else if (name == "lattice") {
+        method = JITTERED_LATTICE;
+    } else if (name == "poisson") {
+        method = POISSON_DISK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+size_t Placement::generate(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses)
+{
+    initGrid();
+    poses.clear();
+    poses.reserve(n);
+
+    size_t placed = 0;
+    switch (m_eMethod) {
+    case JITTERED_LATTICE:
+        placed = lattice(n, rng, poses);
+        break;
+    case POISSON_DISK:
+        placed = poisson(n, rng, poses);
+        break;
+    case UNIFORM:
+    default:
+        placed = uniform(n, rng, poses);
+    }
+
+    // whatever could not be placed goes anywhere
+    while (poses.size() < n) {
+        Pose p;
+        p.x = rng->Uniform(m_arenaX);
+        p.y = rng->Uniform(m_arenaY);
+        p.angle = rng->Uniform(CRadians::UNSIGNED_RANGE).GetValue();
+        poses.push_back(p);
+    }
+    return placed;
+}
+
+void Placement::initGrid()
+{
+    m_fCellSize = m_fMinDistance / std::sqrt(2.0);
+    m_iCols = std::max<size_t>(1, (size_t) std::ceil(m_arenaX.GetSpan() / m_fCellSize));
+    m_iRows = std::max<size_t>(1, (size_t) std::ceil(m_arenaY.GetSpan() / m_fCellSize));
+    m_grid.assign(m_iCols * m_iRows, -1);
+}
+
+size_t Placement::cellOf(Real x, Real y) const
+{
+    size_t cx = std::min(m_iCols - 1, (size_t) ((x - m_arenaX.GetMin()) / m_fCellSize));
+    size_t cy = std::min(m_iRows - 1, (size_t) ((y - m_arenaY.GetMin()) / m_fCellSize));
+    return cy * m_iCols + cx;
+}
+
+bool Placement::fits(Real x, Real y, const std::vector<Pose>& poses) const
+{
+    if (x < m_arenaX.GetMin() || x > m_arenaX.GetMax()
+            || y < m_arenaY.GetMin() || y > m_arenaY.GetMax()) {
+        return false;
+    }
+
+    // with cells of side d/sqrt(2), a neighbour closer
+    // than d is at most two cells away
+    const size_t cell = cellOf(x, y);
+    const long cx = cell % m_iCols;
+    const long cy = cell / m_iCols;
+    const Real d2 = m_fMinDistance * m_fMinDistance;
+    for (long j = std::max(0L, cy - 2); j <= std::min((long) m_iRows - 1, cy + 2); ++j) {
+        for (long i = std::max(0L, cx - 2); i <= std::min((long) m_iCols - 1, cx + 2); ++i) {
+            const int32_t idx = m_grid[j * m_iCols + i];
+            if (idx >= 0) {
+                const Real dx = poses[idx].x - x;
+                const Real dy = poses[idx].y - y;
+                if (dx * dx + dy * dy < d2) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void Placement::insert(size_t idx, const std::vector<Pose>& poses)
+{
+    m_grid[cellOf(poses[idx].x, poses[idx].y)] = (int32_t) idx;
+}
+
+size_t Placement::uniform(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (int trial = 0; trial < MAX_UNIFORM_TRIALS; ++trial) {
+            Pose p;
+            p.x = rng->Uniform(m_arenaX);
+            p.y = rng->Uniform(m_arenaY);
+            if (fits(p.x, p.y, poses)) {
+                p.angle = rng->Uniform(CRadians::UNSIGNED_RANGE).GetValue();
+                poses.push_back(p);
+                insert(poses.size() - 1, poses);
+                break;
+            }
+        }
+    }
+    return poses.size();
+}
+
+size_t Placement::lattice(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    // as square as possible lattice with at least n sites
+    const Real aspect = m_arenaY.GetSpan() > 0 ? m_arenaX.GetSpan() / m_arenaY.GetSpan() : 1;
+    const size_t cols = std::max<size_t>(1, (size_t) std::ceil(std::sqrt(n * aspect)));
+    const size_t rows = (n + cols - 1) / cols;
+    const Real sx = m_arenaX.GetSpan() / cols;
+    const Real sy = m_arenaY.GetSpan() / rows;
+    // the jitter never lets two neighbours get closer than minDistance
+    const CRange<Real> jitterX(-std::max(0.0, (sx - m_fMinDistance) / 2), std::max(0.0, (sx - m_fMinDistance) / 2));
+    const CRange<Real> jitterY(-std::max(0.0, (sy - m_fMinDistance) / 2), std::max(0.0, (sy - m_fMinDistance) / 2));
+
+    // pick n random sites (partial Fisher-Yates)
+    std::vector<uint32_t> sites(cols * rows);
+    for (size_t i = 0; i < sites.size(); ++i) sites[i] = i;
+
+    std::vector<Pose> failed;
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t r = rng->Uniform(CRange<UInt32>(i, sites.size()));
+        std::swap(sites[i], sites[r]);
+
+        Pose p;
+        p.x = m_arenaX.GetMin() + (sites[i] % cols + 0.5) * sx + rng->Uniform(jitterX);
+        p.y = m_arenaY.GetMin() + (sites[i] / cols + 0.5) * sy + rng->Uniform(jitterY);
+        p.angle = rng->Uniform(CRadians::UNSIGNED_RANGE).GetValue();
+        if (fits(p.x, p.y, poses)) {
+            poses.push_back(p);
+            insert(poses.size() - 1, poses);
+        } else {
+            failed.push_back(p); // lattice too dense
+        }
+    }
+
+    const size_t placed = poses.size();
+    poses.insert(poses.end(), failed.begin(), failed.end());
+    return placed;
+}
+
+size_t Placement::poisson(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    // sample the whole arena (Bridson), then keep n random samples;
+    // stopping the growth earlier would leave the robots in a cluster
+    std::vector<Pose> samples;
+    std::vector<uint32_t> active;
+    const CRange<Real> radius(m_fMinDistance, 2 * m_fMinDistance);
+
+    Pose first;
+    first.x = rng->Uniform(m_arenaX);
+    first.y = rng->Uniform(m_arenaY);
+    samples.push_back(first);
+    insert(0, samples);
+    active.push_back(0);
+
+    while (!active.empty()) {
+        const uint32_t a = rng->Uniform(CRange<UInt32>(0, active.size()));
+        const Pose center = samples[active[a]];
+
+        bool found = false;
+        for (int k = 0; k < POISSON_CANDIDATES; ++k) {
+            const Real r = rng->Uniform(radius);
+            const Real theta = rng->Uniform(CRadians::UNSIGNED_RANGE).GetValue();
+            Pose p;
+            p.x = center.x + r * std::cos(theta);
+            p.y = center.y + r * std::sin(theta);
+            if (fits(p.x, p.y, samples)) {
+                samples.push_back(p);
+                insert(samples.size() - 1, samples);
+                active.push_back(samples.size() - 1);
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            active[a] = active.back();
+            active.pop_back();
+        }
+    }
+
+    // keep n random samples (partial Fisher-Yates)
+    const size_t placed = std::min(n, samples.size());
+    for (size_t i = 0; i < placed; ++i) {
+        const uint32_t r = rng->Uniform(CRange<UInt32>(i, samples.size()));
+        std::swap(samples[i], samples[r]);
+        samples[i].angle = rng->Uniform(CRadians::UNSIGNED_RANGE).GetValue();
+        poses.push_back(samples[i]);
+    }
+    return placed;
+}
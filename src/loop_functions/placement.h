@@ -0,0 +1,98 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <argos3/core/utility/math/rng.h>
+
+#include <string>
+#include <vector>
+
+using namespace argos;
+
+// radius of a kilobot (as in the kilobot plugin of ARGoS), in meters
+#define KILOBOT_RADIUS 0.0165
+
+/**
+ * @brief The Placement class
+ * Computes the initial position of the robots, making sure that no two robots
+ * are closer than 'minDistance'. Overlaps are checked with a uniform grid (at
+ * most one robot per cell), so placing N robots costs O(N). The centres are
+ * kept KILOBOT_RADIUS away from the borders of the arena (the walls).
+ *  - UNIFORM: uniform random positions (rejection sampling)
+ *  - JITTERED_LATTICE: a regular lattice with random jitter
+ *  - POISSON_DISK: Bridson's Poisson-disk sampling
+ * @author KilobotGA contributors
+ */
+class Placement
+{
+
+public:
+    enum Method {
+        UNIFORM,
+        JITTERED_LATTICE,
+        POISSON_DISK
+    };
+
+    struct Pose {
+        Real x;
+        Real y;
+        Real angle; // radians
+    };
+
+    Placement();
+
+    // 'uniform', 'lattice' or 'poisson'
+    static bool parseMethod(const std::string& name, Method& method);
+
+    inline void setMethod(Method method) { m_eMethod = method; }
+    void setArena(const CRange<Real>& x, const CRange<Real>& y);
+    inline void setMinDistance(Real d) { m_fMinDistance = d; }
+
+    // area where the centre of a robot can be (the arena inset by KILOBOT_RADIUS)
+    inline const CRange<Real>& arenaX() const { return m_arenaX; }
+    inline const CRange<Real>& arenaY() const { return m_arenaY; }
+
+    // fill 'poses' with 'n' poses and return how many of them do not overlap;
+    // robots which could not be placed come last (at random positions)
+    size_t generate(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses);
+
+private:
+    Method m_eMethod;
+    CRange<Real> m_arenaX; // inset by KILOBOT_RADIUS
+    CRange<Real> m_arenaY;
+    Real m_fMinDistance;
+
+    // uniform grid with cells of side minDistance/sqrt(2)
+    Real m_fCellSize;
+    size_t m_iCols;
+    size_t m_iRows;
+    std::vector<int32_t> m_grid; // index of the pose in each cell (-1 = empty)
+
+    void initGrid();
+    size_t cellOf(Real x, Real y) const;
+    bool fits(Real x, Real y, const std::vector<Pose>& poses) const;
+    void insert(size_t idx, const std::vector<Pose>& poses);
+
+    size_t uniform(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses);
+    size_t lattice(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses);
+    size_t poisson(size_t n, CRandom::CRNG* rng, std::vector<Pose>& poses);
+};
+
+#endif // PLACEMENT_H
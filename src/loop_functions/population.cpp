@@ -0,0 +1,47 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "population.h"
+
+// chromosomes are aligned to this boundary (in bytes)
+#define CHROMOSOME_ALIGNMENT 16
+
+Population::Population()
+    : m_iPopSize(0)
+    , m_iGeneSize(0)
+    , m_iLength(0)
+    , m_iStride(0)
+    , m_iGenerationSize(0)
+    , m_iCurrent(0)
+{
+}
+
+void Population::allocate(size_t popSize, size_t geneSize, size_t chromosomeLength)
+{
+    m_iPopSize = popSize;
+    m_iGeneSize = geneSize;
+    m_iLength = chromosomeLength;
+
+    // pad each chromosome, so that they all start at an aligned address
+    const size_t bytes = geneSize * chromosomeLength;
+    m_iStride = (bytes + CHROMOSOME_ALIGNMENT - 1) / CHROMOSOME_ALIGNMENT * CHROMOSOME_ALIGNMENT;
+    m_iGenerationSize = m_iStride * popSize;
+    m_iCurrent = 0;
+
+    m_buffer.assign(2 * m_iGenerationSize, 0);
+}
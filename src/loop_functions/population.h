@@ -0,0 +1,73 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "controllers/chromosome.h"
+
+/**
+ * @brief The Population class
+ * A flat arena holding the chromosomes of two generations: the current one
+ * (being evaluated) and the next one (being bred). At the end of each
+ * generation, swap() turns the next generation into the current one, so the
+ * generation turnover does no allocation nor copy.
+ * @author KilobotGA contributors
+ */
+class Population
+{
+
+public:
+    Population();
+
+    // allocate room for two generations of 'popSize' chromosomes
+    void allocate(size_t popSize, size_t geneSize, size_t chromosomeLength);
+
+    inline size_t size() const { return m_iPopSize; }
+    inline size_t geneSize() const { return m_iGeneSize; }
+    inline size_t chromosomeLength() const { return m_iLength; }
+    // distance (in bytes) between two consecutive chromosomes
+    inline size_t stride() const { return m_iStride; }
+    // size (in bytes) of a generation, i.e., size() * stride()
+    inline size_t generationSize() const { return m_iGenerationSize; }
+
+    inline ChromosomeView current(size_t i) { return view(m_iCurrent, i); }
+    inline ChromosomeView next(size_t i) { return view(1 - m_iCurrent, i); }
+
+    // raw buffer of each generation (i.e., 'size()' chromosomes of 'stride()' bytes)
+    inline const uint8_t* currentData() const { return &m_buffer[m_iCurrent * m_iGenerationSize]; }
+    inline uint8_t* nextData() { return &m_buffer[(1 - m_iCurrent) * m_iGenerationSize]; }
+
+    // the next generation becomes the current one
+    inline void swap() { m_iCurrent = 1 - m_iCurrent; }
+
+private:
+    std::vector<uint8_t> m_buffer;
+    size_t m_iPopSize;
+    size_t m_iGeneSize;
+    size_t m_iLength;
+    size_t m_iStride;
+    size_t m_iGenerationSize;
+    size_t m_iCurrent; // 0 or 1
+
+    inline ChromosomeView view(size_t half, size_t i) {
+        return ChromosomeView(&m_buffer[half * m_iGenerationSize + i * m_iStride], m_iGeneSize, m_iLength);
+    }
+};
+
+#endif // POPULATION_H
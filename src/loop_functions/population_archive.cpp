@@ -0,0 +1,458 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "population_archive.h"
+
+#include <vector>
+
+static inline uint64_t align(uint64_t n)
+{
+    return (n + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+static inline uint64_t fitnessColumnSize(uint32_t popSize)
+{
+    return align(popSize * sizeof(float));
+}
+
+static inline uint64_t deltaSize(uint32_t popSize, uint32_t changes, size_t geneSize)
+{
+    return (2 * (uint64_t) popSize + 1 + changes) * sizeof(uint32_t) + (uint64_t) changes * geneSize;
+}
+
+/************************************************************************/
+
+ArchiveWriter::ArchiveWriter()
+    : m_iKeyframeInterval(1)
+    , m_iPrevious(-1)
+{
+    memset(&m_header, 0, sizeof(ArchiveHeader));
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+    close();
+}
+
+bool ArchiveWriter::open(const QString& fileName, const GeneDescriptor& gene, uint32_t chromosomeLength,
+                         uint32_t chromosomeStride, uint32_t popSize, uint32_t maxGenerations)
+{
+    close();
+
+    memset(&m_header, 0, sizeof(ArchiveHeader));
+    memcpy(m_header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    m_header.version = ARCHIVE_VERSION;
+    m_header.headerSize = sizeof(ArchiveHeader);
+    m_header.gene = gene;
+    m_header.chromosomeLength = chromosomeLength;
+    m_header.chromosomeStride = chromosomeStride;
+    m_header.popSize = popSize;
+    m_header.maxGenerations = maxGenerations;
+    m_header.indexOffset = align(sizeof(ArchiveHeader));
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        return fail("unable to create");
+    }
+
+    // header and an empty index
+    const uint64_t dataOffset = align(m_header.indexOffset + maxGenerations * sizeof(uint64_t));
+    std::vector<char> head(dataOffset, 0);
+    memcpy(&head[0], &m_header, sizeof(ArchiveHeader));
+    if (m_file.write(&head[0], head.size()) != (qint64) head.size()) {
+        return fail("unable to write the header of");
+    }
+    return true;
+}
+
+bool ArchiveWriter::reopen(const QString& fileName, uint32_t lastGeneration)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return fail("unable to open");
+    }
+
+    if (m_file.read((char*) &m_header, sizeof(ArchiveHeader)) != sizeof(ArchiveHeader)
+            || memcmp(m_header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0
+            || m_header.version < 1 || m_header.version > ARCHIVE_VERSION) {
+        close();
+        return fail("not a valid population archive:");
+    }
+
+    // version 1 is a subset of the current one (keyframes only)
+    if (m_header.version != ARCHIVE_VERSION) {
+        m_header.version = ARCHIVE_VERSION;
+        if (!m_file.seek(0) || m_file.write((const char*) &m_header, sizeof(ArchiveHeader)) != sizeof(ArchiveHeader)) {
+            return fail("unable to upgrade");
+        }
+    }
+
+    // the generations written after the checkpoint will be produced again;
+    // their blocks stay in the file, but are no longer reachable
+    if (lastGeneration + 1 < m_header.maxGenerations) {
+        const std::vector<uint64_t> missing(m_header.maxGenerations - lastGeneration - 1, 0);
+        const qint64 bytes = missing.size() * sizeof(uint64_t);
+        if (!m_file.seek(m_header.indexOffset + (lastGeneration + 1) * sizeof(uint64_t))
+                || m_file.write((const char*) missing.data(), bytes) != bytes
+                || !m_file.flush()) {
+            return fail("unable to truncate the index of");
+        }
+    }
+    return true;
+}
+
+void ArchiveWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    // the next generation is a keyframe
+    m_iPrevious = -1;
+}
+
+bool ArchiveWriter::writeGeneration(uint32_t generation, const float* fitness, const uint8_t* genes,
+                                    const uint32_t* parents)
+{
+    if (!m_file.isOpen()) {
+        return fail("archive is not open:");
+    }
+    if (generation >= m_header.maxGenerations) {
+        return fail(QString("generation %1 is out of range in").arg(generation));
+    }
+
+    const qint64 offset = align(m_file.size());
+    if (!m_file.seek(offset)) {
+        return fail("unable to seek in");
+    }
+
+    ArchiveBlockHeader block;
+    block.generation = generation;
+    block.popSize = m_header.popSize;
+    block.kind = ARCHIVE_KEYFRAME;
+    block.bytes = 0;
+
+    // a delta is only worth it if it is smaller than the generation
+    const qint64 genesBytes = (qint64) m_header.popSize * m_header.chromosomeStride;
+    if (m_iKeyframeInterval > 1 && generation % m_iKeyframeInterval != 0 && m_iPrevious + 1 == generation) {
+        const uint64_t bytes = encodeDelta(genes, parents);
+        if (bytes < (uint64_t) genesBytes) {
+            block.kind = ARCHIVE_DELTA;
+            block.bytes = bytes;
+        }
+    }
+
+    // each column is written at once
+    const qint64 fitnessBytes = m_header.popSize * sizeof(float);
+    const qint64 padding = fitnessColumnSize(m_header.popSize) - fitnessBytes;
+    static const char zeros[ARCHIVE_ALIGNMENT] = { 0 };
+    bool ok = m_file.write((const char*) &block, sizeof(block)) == sizeof(block)
+           && m_file.write((const char*) fitness, fitnessBytes) == fitnessBytes
+           && m_file.write(zeros, padding) == padding;
+    if (block.kind == ARCHIVE_KEYFRAME) {
+        ok = ok && m_file.write((const char*) genes, genesBytes) == genesBytes;
+    } else {
+        const qint64 baseBytes = m_base.size() * sizeof(uint32_t);
+        const qint64 firstBytes = m_first.size() * sizeof(uint32_t);
+        const qint64 positionBytes = m_positions.size() * sizeof(uint32_t);
+        const qint64 valueBytes = m_values.size();
+        ok = ok && m_file.write((const char*) m_base.data(), baseBytes) == baseBytes
+                && m_file.write((const char*) m_first.data(), firstBytes) == firstBytes
+                && m_file.write((const char*) m_positions.data(), positionBytes) == positionBytes
+                && m_file.write((const char*) m_values.data(), valueBytes) == valueBytes;
+    }
+    if (!ok) {
+        m_iPrevious = -1;
+        return fail(QString("unable to write generation %1 in").arg(generation));
+    }
+
+    // only now the generation becomes visible to the readers
+    const uint64_t blockOffset = offset;
+    if (!m_file.seek(m_header.indexOffset + generation * sizeof(uint64_t))
+            || m_file.write((const char*) &blockOffset, sizeof(uint64_t)) != sizeof(uint64_t)
+            || !m_file.flush()) {
+        m_iPrevious = -1;
+        return fail(QString("unable to index generation %1 in").arg(generation));
+    }
+
+    // the base of the next delta
+    if (m_iKeyframeInterval > 1) {
+        m_previous.assign(genes, genes + genesBytes);
+        m_iPrevious = generation;
+    }
+    return true;
+}
+
+uint32_t ArchiveWriter::changes(const uint8_t* chromosome, uint32_t base) const
+{
+    const size_t geneSize = m_header.gene.geneSize();
+    const uint8_t* previous = &m_previous[(size_t) base * m_header.chromosomeStride];
+    uint32_t n = 0;
+    for (uint32_t g = 0; g < m_header.chromosomeLength; ++g) {
+        n += memcmp(chromosome + g * geneSize, previous + g * geneSize, geneSize) != 0;
+    }
+    return n;
+}
+
+uint64_t ArchiveWriter::encodeDelta(const uint8_t* genes, const uint32_t* parents)
+{
+    const uint32_t popSize = m_header.popSize;
+    const size_t geneSize = m_header.gene.geneSize();
+    m_base.resize(popSize);
+    m_first.resize(popSize + 1);
+    m_positions.clear();
+    m_values.clear();
+
+    for (uint32_t i = 0; i < popSize; ++i) {
+        const uint8_t* chromosome = genes + (size_t) i * m_header.chromosomeStride;
+
+        // the closest of the candidates (the same id, then the parents)
+        uint32_t base = i;
+        uint32_t best = changes(chromosome, i);
+        for (int p = 0; parents && p < 2 && best > 0; ++p) {
+            const uint32_t candidate = parents[2 * i + p];
+            if (candidate < popSize && candidate != base) {
+                const uint32_t n = changes(chromosome, candidate);
+                if (n < best) {
+                    best = n;
+                    base = candidate;
+                }
+            }
+        }
+
+        m_base[i] = base;
+        m_first[i] = m_positions.size();
+        if (best == 0) {
+            continue;
+        }
+        const uint8_t* previous = &m_previous[(size_t) base * m_header.chromosomeStride];
+        for (uint32_t g = 0; g < m_header.chromosomeLength; ++g) {
+            const uint8_t* gene = chromosome + g * geneSize;
+            if (memcmp(gene, previous + g * geneSize, geneSize) != 0) {
+                m_positions.push_back(g);
+                m_values.insert(m_values.end(), gene, gene + geneSize);
+            }
+        }
+    }
+    m_first[popSize] = m_positions.size();
+    return deltaSize(popSize, m_positions.size(), geneSize);
+}
+
+bool ArchiveWriter::fail(const QString& what)
+{
+    m_sError = QString("%1 %2 (%3)").arg(what).arg(m_file.fileName()).arg(m_file.errorString());
+    return false;
+}
+
+/************************************************************************/
+
+ArchiveReader::ArchiveReader()
+    : m_data(NULL)
+    , m_iSize(0)
+    , m_header(NULL)
+    , m_index(NULL)
+    , m_iDecoded(-1)
+{
+}
+
+ArchiveReader::~ArchiveReader()
+{
+    close();
+}
+
+bool ArchiveReader::open(const QString& fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_sError = QString("unable to open %1 (%2)").arg(fileName).arg(m_file.errorString());
+        return false;
+    }
+
+    m_iSize = m_file.size();
+    if (m_iSize < (qint64) sizeof(ArchiveHeader)) {
+        m_sError = QString("%1 is not a population archive").arg(fileName);
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_iSize);
+    if (!m_data) {
+        m_sError = QString("unable to map %1 (%2)").arg(fileName).arg(m_file.errorString());
+        close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<const ArchiveHeader*>(m_data);
+    if (memcmp(m_header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0
+            || m_header->version < 1 || m_header->version > ARCHIVE_VERSION
+            || m_header->gene.geneSize() * m_header->chromosomeLength > m_header->chromosomeStride
+            || m_header->indexOffset + m_header->maxGenerations * sizeof(uint64_t) > (uint64_t) m_iSize) {
+        m_sError = QString("%1 is not a valid population archive").arg(fileName);
+        close();
+        return false;
+    }
+
+    m_index = reinterpret_cast<const uint64_t*>(m_data + m_header->indexOffset);
+    return true;
+}
+
+void ArchiveReader::close()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+    }
+    m_data = NULL;
+    m_header = NULL;
+    m_index = NULL;
+    m_iSize = 0;
+    m_iDecoded = -1;
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool ArchiveReader::hasGeneration(uint32_t generation) const
+{
+    if (!m_index || generation >= m_header->maxGenerations || m_index[generation] == 0
+            || m_index[generation] + sizeof(ArchiveBlockHeader) > (uint64_t) m_iSize) {
+        return false;
+    }
+    const ArchiveBlockHeader* b = blockHeader(generation);
+    uint64_t blockSize = sizeof(ArchiveBlockHeader) + fitnessColumnSize(m_header->popSize);
+    if (b->kind == ARCHIVE_KEYFRAME) {
+        blockSize += (uint64_t) m_header->popSize * m_header->chromosomeStride;
+    } else {
+        // a delta also needs the generation before it
+        blockSize += b->bytes;
+        if (generation == 0 || m_index[generation - 1] == 0) {
+            return false;
+        }
+    }
+    return m_index[generation] + blockSize <= (uint64_t) m_iSize;
+}
+
+int ArchiveReader::lastGeneration() const
+{
+    if (!m_index) {
+        return -1;
+    }
+    for (int g = m_header->maxGenerations - 1; g >= 0; --g) {
+        if (hasGeneration(g)) {
+            return g;
+        }
+    }
+    return -1;
+}
+
+const ArchiveBlockHeader* ArchiveReader::blockHeader(uint32_t generation) const
+{
+    return reinterpret_cast<const ArchiveBlockHeader*>(m_data + m_index[generation]);
+}
+
+const uint8_t* ArchiveReader::block(uint32_t generation) const
+{
+    return m_data + m_index[generation] + sizeof(ArchiveBlockHeader);
+}
+
+const uint8_t* ArchiveReader::payload(uint32_t generation) const
+{
+    return block(generation) + fitnessColumnSize(m_header->popSize);
+}
+
+const float* ArchiveReader::fitness(uint32_t generation) const
+{
+    return reinterpret_cast<const float*>(block(generation));
+}
+
+const uint8_t* ArchiveReader::genes(uint32_t generation) const
+{
+    if (blockHeader(generation)->kind == ARCHIVE_KEYFRAME) {
+        return payload(generation);
+    }
+    if (m_iDecoded == generation) {
+        return m_decoded.data();
+    }
+
+    // go back to a keyframe, or to the generation we have already decoded
+    uint32_t first = generation;
+    while (first != m_iDecoded && blockHeader(first)->kind == ARCHIVE_DELTA) {
+        if (!hasGeneration(first - 1)) {
+            return NULL;
+        }
+        --first;
+    }
+
+    const size_t genesBytes = (size_t) m_header->popSize * m_header->chromosomeStride;
+    m_decoded.resize(genesBytes);
+    m_scratch.resize(genesBytes);
+    if (first != m_iDecoded) {
+        memcpy(m_decoded.data(), payload(first), genesBytes);
+    }
+    for (uint32_t g = first + 1; g <= generation; ++g) {
+        if (!applyDelta(g, m_decoded.data(), m_scratch.data())) {
+            m_iDecoded = -1;
+            return NULL;
+        }
+        m_decoded.swap(m_scratch);
+    }
+    m_iDecoded = generation;
+    return m_decoded.data();
+}
+
+bool ArchiveReader::applyDelta(uint32_t generation, const uint8_t* previous, uint8_t* genes) const
+{
+    const uint32_t popSize = m_header->popSize;
+    const uint32_t stride = m_header->chromosomeStride;
+    const size_t geneSize = m_header->gene.geneSize();
+    const uint32_t* base = reinterpret_cast<const uint32_t*>(payload(generation));
+    const uint32_t* first = base + popSize;
+    const uint32_t* positions = first + popSize + 1;
+    const uint32_t changes = first[popSize];
+    const uint8_t* values = reinterpret_cast<const uint8_t*>(positions + changes);
+    if (blockHeader(generation)->bytes != deltaSize(popSize, changes, geneSize)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < popSize; ++i) {
+        if (base[i] >= popSize || first[i] > first[i + 1] || first[i + 1] > changes) {
+            return false;
+        }
+        uint8_t* chromosome = genes + (size_t) i * stride;
+        memcpy(chromosome, previous + (size_t) base[i] * stride, stride);
+        for (uint32_t c = first[i]; c < first[i + 1]; ++c) {
+            if (positions[c] >= m_header->chromosomeLength) {
+                return false;
+            }
+            memcpy(chromosome + positions[c] * geneSize, values + (size_t) c * geneSize, geneSize);
+        }
+    }
+    return true;
+}
+
+const ChromosomeView ArchiveReader::chromosome(uint32_t generation, uint32_t id) const
+{
+    const uint8_t* all = genes(generation);
+    if (!all) {
+        return ChromosomeView();
+    }
+    const uint8_t* chromosome = all + (uint64_t) id * m_header->chromosomeStride;
+    return ChromosomeView(const_cast<uint8_t*>(chromosome), m_header->gene.geneSize(), m_header->chromosomeLength);
+}
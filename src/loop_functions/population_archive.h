@@ -0,0 +1,185 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POPULATION_ARCHIVE_H
+#define POPULATION_ARCHIVE_H
+
+#include "controllers/chromosome.h"
+
+#include <QFile>
+#include <QString>
+
+#include <vector>
+
+/*
+ * Binary archive holding all generations of a run in a single file.
+ * All numbers are stored in the native (little-endian) byte order.
+ *
+ *   ArchiveHeader
+ *   uint64_t index[maxGenerations]  // file offset of each generation (0 = missing)
+ *   generation blocks, appended in any order:
+ *     ArchiveBlockHeader
+ *     float fitness[popSize]        // padded to ARCHIVE_ALIGNMENT
+ *     ARCHIVE_KEYFRAME:
+ *       uint8_t genes[popSize][chromosomeStride]
+ *     ARCHIVE_DELTA (the changes since the previous generation):
+ *       uint32_t base[popSize]        // chromosome of the previous generation it starts from
+ *       uint32_t first[popSize + 1]   // changes of chromosome i are [first[i], first[i+1])
+ *       uint32_t position[changes]    // index of each changed gene
+ *       uint8_t value[changes][geneSize]
+ *
+ * Every section starts at a multiple of ARCHIVE_ALIGNMENT, so the genes of a
+ * keyframe can be accessed in place once the file is memory-mapped; a delta
+ * is applied on top of the generation before it, down to a keyframe.
+ * Version 1 archives only have keyframes.
+ */
+
+#define ARCHIVE_FILENAME "population.kga"
+#define ARCHIVE_MAGIC "KGA-POP"
+#define ARCHIVE_VERSION 2
+#define ARCHIVE_ALIGNMENT 16
+#define ARCHIVE_KEYFRAME 0
+#define ARCHIVE_DELTA 1
+
+struct ArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    GeneDescriptor gene;
+    uint32_t chromosomeLength; // number of genes
+    uint32_t chromosomeStride; // bytes between two chromosomes
+    uint32_t popSize;
+    uint32_t maxGenerations;
+    uint64_t indexOffset;
+};
+
+struct ArchiveBlockHeader {
+    uint32_t generation;
+    uint32_t popSize;
+    uint32_t kind;  // ARCHIVE_KEYFRAME or ARCHIVE_DELTA
+    uint32_t bytes; // size of a delta (after the fitness)
+};
+
+/**
+ * @brief The ArchiveWriter class
+ * Appends generations to a population archive (one bulk write per column).
+ * A generation is stored as a delta when the one before it was the last
+ * written generation, except every 'keyframeInterval' generations or when
+ * the delta would not be smaller than the whole generation.
+ * @author KilobotGA contributors
+ */
+class ArchiveWriter
+{
+
+public:
+    ArchiveWriter();
+    ~ArchiveWriter();
+
+    // create a new archive (any existing file is truncated)
+    bool open(const QString& fileName, const GeneDescriptor& gene, uint32_t chromosomeLength,
+              uint32_t chromosomeStride, uint32_t popSize, uint32_t maxGenerations);
+    // open an existing archive to store more generations; the generations
+    // after 'lastGeneration' are removed from the index
+    bool reopen(const QString& fileName, uint32_t lastGeneration);
+    void close();
+
+    inline bool isOpen() const { return m_file.isOpen(); }
+    inline const ArchiveHeader& header() const { return m_header; }
+    inline const QString& errorString() const { return m_sError; }
+
+    // 1 = keyframes only (default)
+    inline void setKeyframeInterval(uint32_t interval) { m_iKeyframeInterval = interval; }
+
+    // 'genes' holds popSize chromosomes of chromosomeStride bytes;
+    // 'parents' (optional) holds two candidates per chromosome, i.e., the ids
+    // in the previous generation it most likely derives from
+    bool writeGeneration(uint32_t generation, const float* fitness, const uint8_t* genes,
+                         const uint32_t* parents = NULL);
+
+private:
+    QFile m_file;
+    ArchiveHeader m_header;
+    QString m_sError;
+
+    uint32_t m_iKeyframeInterval;
+    int64_t m_iPrevious;            // last generation written (-1 = none)
+    std::vector<uint8_t> m_previous; // and its genes
+    // the delta being written
+    std::vector<uint32_t> m_base;
+    std::vector<uint32_t> m_first;
+    std::vector<uint32_t> m_positions;
+    std::vector<uint8_t> m_values;
+
+    bool fail(const QString& what);
+    // return the size of the delta
+    uint64_t encodeDelta(const uint8_t* genes, const uint32_t* parents);
+    uint32_t changes(const uint8_t* chromosome, uint32_t base) const;
+};
+
+/**
+ * @brief The ArchiveReader class
+ * Gives random access to the generations of a population archive.
+ * The file is memory-mapped, so keyframes are neither parsed nor copied;
+ * deltas are decoded into a buffer, which also speeds up reading the
+ * generations in order.
+ * @author KilobotGA contributors
+ */
+class ArchiveReader
+{
+
+public:
+    ArchiveReader();
+    ~ArchiveReader();
+
+    bool open(const QString& fileName);
+    void close();
+
+    inline const ArchiveHeader& header() const { return *m_header; }
+    inline const QString& errorString() const { return m_sError; }
+
+    bool hasGeneration(uint32_t generation) const;
+    // the last generation stored in the archive (-1 if empty)
+    int lastGeneration() const;
+
+    // generation must exist; the fitness is valid until close(), the
+    // chromosome of a delta only until another generation is decoded
+    const float* fitness(uint32_t generation) const;
+    const ChromosomeView chromosome(uint32_t generation, uint32_t id) const;
+    // all chromosomes of a generation (NULL if the archive is corrupted)
+    const uint8_t* genes(uint32_t generation) const;
+
+private:
+    QFile m_file;
+    uchar* m_data;
+    qint64 m_iSize;
+    const ArchiveHeader* m_header;
+    const uint64_t* m_index;
+    QString m_sError;
+
+    mutable int64_t m_iDecoded;            // generation in m_decoded (-1 = none)
+    mutable std::vector<uint8_t> m_decoded;
+    mutable std::vector<uint8_t> m_scratch;
+
+    const ArchiveBlockHeader* blockHeader(uint32_t generation) const;
+    const uint8_t* block(uint32_t generation) const;
+    // the genes (keyframe) or the delta of a generation
+    const uint8_t* payload(uint32_t generation) const;
+    bool applyDelta(uint32_t generation, const uint8_t* previous, uint8_t* genes) const;
+};
+
+#endif // POPULATION_ARCHIVE_H
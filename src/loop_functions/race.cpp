@@ -0,0 +1,111 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "race.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+Race::Race()
+    : m_bEnabled(false)
+    , m_iInterval(50)
+    , m_fConfidence(2.f)
+    , m_fTolerance(0.f)
+    , m_iElite(1)
+    , m_iTotalTicks(0)
+    , m_iLastTick(0)
+    , m_iStopTick(0)
+    , m_iSamples(0)
+    , m_bOver(false)
+{
+}
+
+void Race::start(uint32_t popSize, uint32_t totalTicks)
+{
+    m_iTotalTicks = totalTicks;
+    m_iLastTick = 0;
+    m_iStopTick = 0;
+    m_iSamples = 0;
+    m_bOver = false;
+    m_last.assign(popSize, 0.f);
+    m_mean.assign(popSize, 0.0);
+    m_m2.assign(popSize, 0.0);
+    m_projected.resize(popSize);
+    m_low.resize(popSize);
+    m_high.resize(popSize);
+    m_order.resize(popSize);
+}
+
+bool Race::checkpoint(uint32_t tick, const std::vector<float>& performance)
+{
+    if (m_bOver || tick <= m_iLastTick) {
+        return m_bOver;
+    }
+
+    // the gain of each robot is a new sample of its rate
+    ++m_iSamples;
+    const uint32_t popSize = m_last.size();
+    for (uint32_t i = 0; i < popSize; ++i) {
+        const double gain = performance[i] - m_last[i];
+        const double delta = gain - m_mean[i];
+        m_mean[i] += delta / m_iSamples;
+        m_m2[i] += delta * (gain - m_mean[i]);
+        m_last[i] = performance[i];
+    }
+    m_iLastTick = tick;
+
+    // a variance needs two samples
+    if (m_iSamples < 2 || tick >= m_iTotalTicks) {
+        return false;
+    }
+
+    // remaining intervals
+    const double r = (double) (m_iTotalTicks - tick) / m_iInterval;
+    for (uint32_t i = 0; i < popSize; ++i) {
+        const double variance = m_m2[i] / (m_iSamples - 1);
+        const double halfWidth = m_fConfidence * std::sqrt(r * variance + r * r * variance / m_iSamples);
+        m_projected[i] = performance[i] + r * m_mean[i];
+        m_low[i] = m_projected[i] - halfWidth;
+        m_high[i] = m_projected[i] + halfWidth;
+    }
+
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b) {
+        return m_projected[a] > m_projected[b];
+    });
+
+    // neighbours in the ranking must be apart (always in the elite)
+    uint32_t overlaps = 0;
+    for (uint32_t k = 0; k + 1 < popSize; ++k) {
+        if (m_low[m_order[k]] < m_high[m_order[k+1]]) {
+            if (k < m_iElite) {
+                return false;
+            }
+            ++overlaps;
+        }
+    }
+    const uint32_t rest = popSize > m_iElite + 1 ? popSize - m_iElite - 1 : 0;
+    if (overlaps > m_fTolerance * rest) {
+        return false;
+    }
+
+    m_bOver = true;
+    m_iStopTick = tick;
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RACE_H
+#define RACE_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief The Race class
+ * Racing of the evaluation of a generation: at every checkpoint, the gain of
+ * performance of each robot since the last checkpoint is a sample of its
+ * rate. The final fitness of a robot is projected from its current
+ * performance and mean rate, within a confidence interval which accounts for
+ * both the noise of the remaining intervals and the error of the mean.
+ * The race is over when the intervals of robots which are next to each other
+ * in the projected ranking do not overlap, i.e., no more ticks can change
+ * the elite nor the outcome of a comparison between two robots. A tolerance
+ * allows some overlaps outside the elite.
+ * @author KilobotGA contributors
+ */
+class Race
+{
+
+public:
+    Race();
+
+    inline void setEnabled(bool enabled) { m_bEnabled = enabled; }
+    inline bool enabled() const { return m_bEnabled; }
+    inline void setInterval(uint32_t ticks) { m_iInterval = ticks > 0 ? ticks : 1; }
+    inline uint32_t interval() const { return m_iInterval; }
+    // half-width of the intervals, in standard deviations
+    inline void setConfidence(float z) { m_fConfidence = z; }
+    // fraction of the non-elite neighbours which may still overlap
+    inline void setTolerance(float tolerance) { m_fTolerance = tolerance; }
+    inline void setElite(uint32_t elite) { m_iElite = elite; }
+
+    // a new evaluation of 'popSize' robots, which lasts 'totalTicks' ticks
+    void start(uint32_t popSize, uint32_t totalTicks);
+
+    // performance of each robot at the given tick;
+    // return true when the race is over
+    bool checkpoint(uint32_t tick, const std::vector<float>& performance);
+
+    inline bool over() const { return m_bOver; }
+    // tick at which the race stopped (the total length if it did not)
+    inline uint32_t ticksUsed() const { return m_bOver ? m_iStopTick : m_iTotalTicks; }
+    // fitness expected at the end of the experiment (only if over)
+    inline float projected(uint32_t id) const { return m_projected[id]; }
+
+private:
+    bool m_bEnabled;
+    uint32_t m_iInterval;
+    float m_fConfidence;
+    float m_fTolerance;
+    uint32_t m_iElite;
+
+    uint32_t m_iTotalTicks;
+    uint32_t m_iLastTick;
+    uint32_t m_iStopTick;
+    uint32_t m_iSamples;
+    bool m_bOver;
+
+    std::vector<float> m_last;   // performance at the last checkpoint
+    std::vector<double> m_mean;  // mean gain per interval
+    std::vector<double> m_m2;    // sum of squared deviations (Welford)
+    std::vector<float> m_projected;
+    std::vector<float> m_low;
+    std::vector<float> m_high;
+    std::vector<uint32_t> m_order;
+};
+
+#endif // RACE_H
@@ -0,0 +1,262 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "surrogate.h"
+#include "controllers/profiler.h"
+
+#include <argos3/core/utility/plugins/factory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+KinematicSurrogate::KinematicSurrogate()
+    : m_arenaX(-0.5, 0.5)
+    , m_arenaY(-0.5, 0.5)
+    , m_fCommRange(KILOBOT_COMM_RANGE)
+    , m_fTickLength(0.1)
+    , m_iTicks(0)
+    , m_iCellsX(1)
+    , m_iCellsY(1)
+{
+    memset(&m_emptyMessage, 0, sizeof(message_t));
+}
+
+KinematicSurrogate::~KinematicSurrogate()
+{
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        m_robots[i]->controller->Destroy();
+        delete m_robots[i]->controller;
+        delete m_robots[i];
+    }
+}
+
+void KinematicSurrogate::setArena(const CRange<Real>& x, const CRange<Real>& y)
+{
+    m_arenaX = x;
+    m_arenaY = y;
+}
+
+void KinematicSurrogate::setClock(Real tickLength, uint32_t ticks)
+{
+    m_fTickLength = tickLength;
+    m_iTicks = ticks;
+}
+
+bool KinematicSurrogate::init(const std::string& controllerType, TConfigurationNode& params,
+                              size_t count, QString& error)
+{
+    m_robots.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        CCI_Controller* controller = CFactory<CCI_Controller>::New(controllerType);
+        AbstractGACtrl* ctrl = dynamic_cast<AbstractGACtrl*>(controller);
+        if (ctrl == NULL) {
+            delete controller;
+            error = QString("'%1' is not a controller of KilobotGA").arg(QString::fromStdString(controllerType));
+            return false;
+        }
+
+        Robot* robot = new Robot;
+        robot->controller = ctrl;
+        robot->x = robot->y = robot->angle = 0;
+        robot->devices.attach(*ctrl);
+        ctrl->SetId(QString("surrogate%1").arg(i).toStdString());
+        ctrl->Init(params);
+        m_robots.push_back(robot);
+    }
+
+    m_cellOf.resize(count);
+    m_sorted.resize(count);
+    m_outbox.resize(count);
+    return true;
+}
+
+void KinematicSurrogate::evaluate(const std::vector<Placement::Pose>& layout,
+                                  const std::vector<ChromosomeView>& chromosomes,
+                                  UInt32 seed, UInt32 stream, std::vector<float>& fitness)
+{
+    KGA_PROFILE(PROFILE_SURROGATE);
+
+    // the cells are never smaller than the comm range
+    m_iCellsX = std::max<uint32_t>(1, m_arenaX.GetSpan() / m_fCommRange);
+    m_iCellsY = std::max<uint32_t>(1, m_arenaY.GetSpan() / m_fCommRange);
+    m_cellStart.resize(m_iCellsX * m_iCellsY + 1);
+
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        Robot* robot = m_robots[i];
+        robot->x = layout[i].x;
+        robot->y = layout[i].y;
+        robot->angle = layout[i].angle;
+        robot->devices.motors.m_fLeft = robot->devices.motors.m_fRight = 0;
+        robot->devices.commOut.m_ptLast = NULL;
+        robot->devices.commIn.packets().clear();
+        robot->controller->setChromosome(chromosomes[i]);
+        robot->controller->setSeed(seed, i, stream, SURROGATE_TRIAL);
+        robot->controller->Reset();
+    }
+
+    for (uint32_t t = 0; t < m_iTicks; ++t) {
+        step();
+    }
+
+    fitness.resize(m_robots.size());
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        fitness[i] = m_robots[i]->controller->getPerformance();
+    }
+}
+
+void KinematicSurrogate::step()
+{
+    // robots receive what was sent in the previous step
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        message_t* message = m_robots[i]->devices.commOut.m_ptLast;
+        m_outbox[i] = message ? message : &m_emptyMessage;
+    }
+
+    buildGrid();
+    deliverMessages();
+
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        m_robots[i]->controller->ControlStep();
+    }
+
+    move();
+    buildGrid();
+    resolveCollisions();
+}
+
+uint32_t KinematicSurrogate::cellX(Real x) const
+{
+    const Real c = (x - m_arenaX.GetMin()) / m_arenaX.GetSpan() * m_iCellsX;
+    return std::min<uint32_t>(m_iCellsX - 1, c > 0 ? (uint32_t) c : 0);
+}
+
+uint32_t KinematicSurrogate::cellY(Real y) const
+{
+    const Real c = (y - m_arenaY.GetMin()) / m_arenaY.GetSpan() * m_iCellsY;
+    return std::min<uint32_t>(m_iCellsY - 1, c > 0 ? (uint32_t) c : 0);
+}
+
+void KinematicSurrogate::buildGrid()
+{
+    // count the robots of each cell, then turn the counts into offsets,
+    // i.e., cell c holds m_sorted[m_cellStart[c], m_cellStart[c+1])
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        m_cellOf[i] = cellY(m_robots[i]->y) * m_iCellsX + cellX(m_robots[i]->x);
+        ++m_cellStart[m_cellOf[i] + 1];
+    }
+    for (size_t c = 1; c < m_cellStart.size(); ++c) {
+        m_cellStart[c] += m_cellStart[c - 1];
+    }
+
+    m_cursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        m_sorted[m_cursor[m_cellOf[i]]++] = i;
+    }
+}
+
+void KinematicSurrogate::deliverMessages()
+{
+    const Real range2 = m_fCommRange * m_fCommRange;
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        Robot* robot = m_robots[i];
+        CCI_KilobotCommunicationSensor::TPackets& packets = robot->devices.commIn.packets();
+        packets.clear(); // keeps the capacity
+
+        const int cx = m_cellOf[i] % m_iCellsX;
+        const int cy = m_cellOf[i] / m_iCellsX;
+        for (int y = std::max(0, cy - 1); y <= std::min<int>(m_iCellsY - 1, cy + 1); ++y) {
+            for (int x = std::max(0, cx - 1); x <= std::min<int>(m_iCellsX - 1, cx + 1); ++x) {
+                const uint32_t cell = y * m_iCellsX + x;
+                for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                    const uint32_t j = m_sorted[k];
+                    if (j == i) continue;
+                    const Real dx = m_robots[j]->x - robot->x;
+                    const Real dy = m_robots[j]->y - robot->y;
+                    const Real d2 = dx * dx + dy * dy;
+                    if (d2 > range2) continue;
+
+                    // distance in mm, as measured by the kilobots
+                    const UInt16 mm = (UInt16) std::min(255.0, std::sqrt(d2) * 1000.0);
+                    CCI_KilobotCommunicationSensor::SPacket packet;
+                    packet.Message = m_outbox[j];
+                    packet.Distance.low_gain = mm;
+                    packet.Distance.high_gain = mm;
+                    packets.push_back(packet);
+                }
+            }
+        }
+    }
+}
+
+void KinematicSurrogate::move()
+{
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        Robot* robot = m_robots[i];
+        // wheel speeds are given in cm/s
+        const Real left = robot->devices.motors.m_fLeft * 0.01;
+        const Real right = robot->devices.motors.m_fRight * 0.01;
+        const Real v = 0.5 * (left + right);
+        const Real w = (right - left) / KILOBOT_WHEEL_DISTANCE;
+
+        robot->angle += w * m_fTickLength;
+        robot->x += v * std::cos(robot->angle) * m_fTickLength;
+        robot->y += v * std::sin(robot->angle) * m_fTickLength;
+
+        // walls
+        robot->x = std::max(m_arenaX.GetMin() + KILOBOT_RADIUS, std::min(m_arenaX.GetMax() - KILOBOT_RADIUS, robot->x));
+        robot->y = std::max(m_arenaY.GetMin() + KILOBOT_RADIUS, std::min(m_arenaY.GetMax() - KILOBOT_RADIUS, robot->y));
+    }
+}
+
+void KinematicSurrogate::resolveCollisions()
+{
+    // a single pass: both disks move back half of the overlap
+    const Real minDistance = 2 * KILOBOT_RADIUS;
+    for (size_t i = 0; i < m_robots.size(); ++i) {
+        Robot* a = m_robots[i];
+        const int cx = m_cellOf[i] % m_iCellsX;
+        const int cy = m_cellOf[i] / m_iCellsX;
+        for (int y = std::max(0, cy - 1); y <= std::min<int>(m_iCellsY - 1, cy + 1); ++y) {
+            for (int x = std::max(0, cx - 1); x <= std::min<int>(m_iCellsX - 1, cx + 1); ++x) {
+                const uint32_t cell = y * m_iCellsX + x;
+                for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                    const uint32_t j = m_sorted[k];
+                    if (j <= i) continue; // each pair once
+                    Robot* b = m_robots[j];
+                    Real dx = b->x - a->x;
+                    Real dy = b->y - a->y;
+                    Real d = std::sqrt(dx * dx + dy * dy);
+                    if (d >= minDistance) continue;
+                    const Real overlap = minDistance - d;
+                    if (d < 1e-9) { // same position; pick a direction
+                        dx = std::cos(a->angle);
+                        dy = std::sin(a->angle);
+                        d = 1;
+                    }
+                    const Real push = 0.5 * overlap / d;
+                    a->x -= dx * push;
+                    a->y -= dy * push;
+                    b->x += dx * push;
+                    b->y += dy * push;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+
+#include "controllers/abstractga_ctrl.h"
+#include "controllers/mock_devices.h"
+#include "placement.h"
+
+#include <QString>
+
+#include <vector>
+
+// kilobot dimensions (as in the kilobot plugin of ARGoS), in meters
+// (KILOBOT_RADIUS is defined in placement.h)
+#define KILOBOT_WHEEL_DISTANCE 0.025
+#define KILOBOT_COMM_RANGE 0.1
+// trial id of the random streams of the surrogate (never used by a real trial)
+#define SURROGATE_TRIAL 0xFFFFFFFF
+
+/**
+ * @brief The KinematicSurrogate class
+ * A cheap approximation of the ARGoS simulation of a kilobot swarm. The
+ * controllers are the real ones, but their devices are mocks driven by a
+ * kinematic model: differential drive (speeds in cm/s, as in ARGoS), robots
+ * are disks pushed apart when they overlap, walls clamp the positions, and
+ * every robot receives the message of all robots within the communication
+ * range (found through a uniform grid). Nothing else is modelled (no noise,
+ * no message collisions, no wheel slip), so the fitness it gives is only an
+ * estimate of the one given by ARGoS.
+ * @author KilobotGA contributors
+ */
+class KinematicSurrogate
+{
+
+public:
+    KinematicSurrogate();
+    ~KinematicSurrogate();
+
+    void setArena(const CRange<Real>& x, const CRange<Real>& y);
+    inline void setCommRange(Real range) { m_fCommRange = range; }
+    // duration of a step (in seconds) and number of steps of an evaluation
+    void setClock(Real tickLength, uint32_t ticks);
+
+    // create 'count' controllers of the given type (as registered in ARGoS)
+    // return false and set the error message if something went wrong
+    bool init(const std::string& controllerType, TConfigurationNode& params, size_t count, QString& error);
+    inline size_t size() const { return m_robots.size(); }
+
+    // evaluate a swarm made of the given genomes (one per robot); the robots
+    // draw from the streams (seed, robot, stream, SURROGATE_TRIAL)
+    void evaluate(const std::vector<Placement::Pose>& layout, const std::vector<ChromosomeView>& chromosomes,
+                  UInt32 seed, UInt32 stream, std::vector<float>& fitness);
+
+private:
+    struct Robot {
+        MockDevices devices;
+        AbstractGACtrl* controller;
+        Real x;
+        Real y;
+        Real angle;
+    };
+
+    std::vector<Robot*> m_robots;
+    CRange<Real> m_arenaX;
+    CRange<Real> m_arenaY;
+    Real m_fCommRange;
+    Real m_fTickLength;
+    uint32_t m_iTicks;
+    message_t m_emptyMessage; // sent by robots which set no message
+
+    // uniform grid (cell side = comm range), rebuilt with a counting sort
+    uint32_t m_iCellsX;
+    uint32_t m_iCellsY;
+    std::vector<uint32_t> m_cellOf;    // cell of each robot
+    std::vector<uint32_t> m_cellStart; // first robot of each cell in m_sorted
+    std::vector<uint32_t> m_sorted;    // robots sorted by cell
+    std::vector<uint32_t> m_cursor;    // scratch of buildGrid()
+    std::vector<message_t*> m_outbox;  // message of each robot in the last step
+
+    void step();
+    void buildGrid();
+    void deliverMessages();
+    void move();
+    void resolveCollisions();
+    uint32_t cellX(Real x) const;
+    uint32_t cellY(Real y) const;
+};
+
+#endif // SURROGATE_H
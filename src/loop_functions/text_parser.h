@@ -0,0 +1,129 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+#include <cmath>
+#include <cstdlib>
+#include <stdint.h>
+
+/**
+ * @brief The TextParser class
+ * Minimal parser of the numbers in our text files. It works on a raw buffer
+ * (no copies, no locale), so a whole file can be parsed in a single pass.
+ * Each function moves 'p' past what it has read.
+ * @author KilobotGA contributors
+ */
+class TextParser
+{
+
+public:
+    static inline void skipBlanks(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    }
+
+    // consume the end of a line ('\n', '\r\n' or the end of the buffer)
+    static inline bool endOfLine(const char*& p, const char* end) {
+        skipBlanks(p, end);
+        if (p < end && *p == '\r') ++p;
+        if (p == end) return true;
+        if (*p != '\n') return false;
+        ++p;
+        return true;
+    }
+
+    static inline bool parseUInt(const char*& p, const char* end, uint32_t& value) {
+        skipBlanks(p, end);
+        const char* begin = p;
+        uint64_t v = 0;
+        while (p < end && *p >= '0' && *p <= '9' && v <= UINT32_MAX) {
+            v = v * 10 + (*p++ - '0');
+        }
+        value = (uint32_t) v;
+        return p > begin && v <= UINT32_MAX;
+    }
+
+    // decimal or scientific notation; anything else (e.g., nan) is left to strtod
+    static inline bool parseFloat(const char*& p, const char* end, float& value) {
+        skipBlanks(p, end);
+        const char* begin = p;
+        const bool negative = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) ++p;
+
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+            if (mantissa < 100000000000000000ULL) mantissa = mantissa * 10 + (*p - '0');
+            else ++exponent; // the extra digits are beyond the float precision
+        }
+        if (p < end && *p == '.') {
+            for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+                if (mantissa < 100000000000000000ULL) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    --exponent;
+                }
+            }
+        }
+        if (digits > 0 && p < end && (*p == 'e' || *p == 'E')) {
+            const char* e = p + 1;
+            const bool negExp = e < end && *e == '-';
+            if (e < end && (*e == '-' || *e == '+')) ++e;
+            uint32_t exp;
+            if (parseUInt(e, end, exp) && exp < 400) {
+                exponent += negExp ? -(int) exp : (int) exp;
+                p = e;
+            }
+        }
+        if (digits == 0) {
+            return slowFloat(begin, p, end, value);
+        }
+
+        const double v = exponent < 0 ? mantissa / pow10(-exponent) : mantissa * pow10(exponent);
+        value = (float) (negative ? -v : v);
+        return true;
+    }
+
+private:
+    static inline double pow10(int e) {
+        static const double table[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        return e < 23 ? table[e] : std::pow(10.0, e);
+    }
+
+    static inline bool slowFloat(const char* begin, const char*& p, const char* end, float& value) {
+        // strtod needs a terminated string; numbers are short
+        char buf[64];
+        size_t n = 0;
+        for (const char* c = begin; c < end && n + 1 < sizeof(buf) && *c != '\t' && *c != ' '
+             && *c != '\n' && *c != '\r'; ++c) {
+            buf[n++] = *c;
+        }
+        buf[n] = '\0';
+        char* stop;
+        const double v = strtod(buf, &stop);
+        if (stop == buf) {
+            return false;
+        }
+        value = (float) v;
+        p = begin + (stop - buf);
+        return true;
+    }
+};
+
+#endif // TEXT_PARSER_H
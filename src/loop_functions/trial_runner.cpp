@@ -0,0 +1,171 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trial_runner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// read exactly 'bytes' from a pipe; return false on EOF or error
+static bool readAll(int fd, char* buf, size_t bytes)
+{
+    while (bytes > 0) {
+        ssize_t n = read(fd, buf, bytes);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const char* buf, size_t bytes)
+{
+    while (bytes > 0) {
+        ssize_t n = write(fd, buf, bytes);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+TrialRunner::TrialRunner()
+    : m_iTrials(1)
+    , m_iWorkers(0)
+    , m_eAggregation(MEAN)
+{
+}
+
+bool TrialRunner::parseAggregation(const std::string& name, Aggregation& aggregation)
+{
+    if (name == "mean") {
+        aggregation = MEAN;
+    } else if (name == "median") {
+        aggregation = MEDIAN;
+    } else if (name == "min") {
+        aggregation = MIN;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool TrialRunner::run(const Trial& trial, size_t popSize, std::vector<float>& fitness, QString& error)
+{
+    m_results.assign(m_iTrials * popSize, 0.f);
+    const uint32_t workers = m_iWorkers > 0 ? std::min(m_iWorkers, m_iTrials) : m_iTrials;
+
+    uint32_t next = 0;
+    while (next < m_iTrials) {
+        // start a batch of trials
+        const uint32_t first = next;
+        std::vector<pid_t> pids;
+        std::vector<int> fds;
+        for (; next < m_iTrials && next - first < workers; ++next) {
+            int fd[2];
+            if (pipe(fd) != 0) {
+                error = QString("unable to create a pipe (%1)").arg(strerror(errno));
+                break;
+            }
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                // child: run the trial and send the results back;
+                // an exception must not unwind into the stack of the parent
+                close(fd[0]);
+                std::vector<float> f(popSize, 0.f);
+                try {
+                    trial(next, f);
+                } catch (...) {
+                    _exit(2);
+                }
+                bool ok = writeAll(fd[1], (const char*) f.data(), popSize * sizeof(float));
+                close(fd[1]);
+                // do not run any destructor nor atexit handler of the parent
+                _exit(ok ? 0 : 1);
+            }
+
+            close(fd[1]);
+            if (pid < 0) {
+                close(fd[0]);
+                error = QString("unable to fork (%1)").arg(strerror(errno));
+                break;
+            }
+            pids.push_back(pid);
+            fds.push_back(fd[0]);
+        }
+
+        // collect the results of the batch
+        for (size_t i = 0; i < pids.size(); ++i) {
+            char* buf = (char*) &m_results[(first + i) * popSize];
+            bool ok = readAll(fds[i], buf, popSize * sizeof(float));
+            close(fds[i]);
+
+            int status = 0;
+            while (waitpid(pids[i], &status, 0) < 0 && errno == EINTR) {}
+            if ((!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) && error.isEmpty()) {
+                error = QString("trial %1 failed").arg(first + (uint32_t) i);
+            }
+        }
+
+        if (!error.isEmpty()) {
+            return false;
+        }
+    }
+
+    aggregate(popSize, fitness);
+    return true;
+}
+
+void TrialRunner::aggregate(size_t popSize, std::vector<float>& fitness)
+{
+    fitness.resize(popSize);
+    std::vector<float> values(m_iTrials);
+    for (size_t r = 0; r < popSize; ++r) {
+        for (uint32_t t = 0; t < m_iTrials; ++t) {
+            values[t] = m_results[t * popSize + r];
+        }
+
+        switch (m_eAggregation) {
+        case MIN:
+            fitness[r] = *std::min_element(values.begin(), values.end());
+            break;
+        case MEDIAN: {
+            const size_t mid = values.size() / 2;
+            std::nth_element(values.begin(), values.begin() + mid, values.end());
+            float median = values[mid];
+            if (values.size() % 2 == 0) {
+                median = (median + *std::max_element(values.begin(), values.begin() + mid)) / 2.f;
+            }
+            fitness[r] = median;
+            break;
+        }
+        case MEAN:
+        default: {
+            double sum = 0.0;
+            for (uint32_t t = 0; t < m_iTrials; ++t) sum += values[t];
+            fitness[r] = (float) (sum / m_iTrials);
+        }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIAL_RUNNER_H
+#define TRIAL_RUNNER_H
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <QString>
+
+/**
+ * @brief The TrialRunner class
+ * Evaluates a generation several times (trials) and aggregates the fitness
+ * of each robot. ARGoS allows only one simulator per process, so each trial
+ * runs in a forked copy of the current process; up to 'workers' trials run
+ * at the same time and send their fitness values back through a pipe.
+ * fork() only copies the calling thread, so the simulator must not use
+ * worker threads (<system threads="0" />), and the trial must not rely on
+ * any other thread of the parent.
+ * @author KilobotGA contributors
+ */
+class TrialRunner
+{
+
+public:
+    enum Aggregation {
+        MEAN,
+        MEDIAN,
+        MIN
+    };
+
+    // runs in the child process; must fill 'fitness' (one value per robot)
+    typedef std::function<void(uint32_t trial, std::vector<float>& fitness)> Trial;
+
+    TrialRunner();
+
+    inline void setTrials(uint32_t trials) { m_iTrials = trials > 0 ? trials : 1; }
+    inline uint32_t trials() const { return m_iTrials; }
+    inline void setWorkers(uint32_t workers) { m_iWorkers = workers; }
+    inline void setAggregation(Aggregation aggregation) { m_eAggregation = aggregation; }
+
+    // 'mean', 'median' or 'min'
+    static bool parseAggregation(const std::string& name, Aggregation& aggregation);
+
+    // fitness of each trial of the last run (trials x popSize)
+    inline const std::vector<float>& results() const { return m_results; }
+
+    // run all trials and store the aggregated fitness in 'fitness'
+    // return false and set the error message if any trial failed
+    bool run(const Trial& trial, size_t popSize, std::vector<float>& fitness, QString& error);
+
+private:
+    uint32_t m_iTrials;
+    uint32_t m_iWorkers; // 0 means one per trial
+    Aggregation m_eAggregation;
+    std::vector<float> m_results; // trials x popSize
+
+    void aggregate(size_t popSize, std::vector<float>& fitness);
+};
+
+#endif // TRIAL_RUNNER_H
@@ -0,0 +1,331 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * kga_sweep: runs a parameter sweep of an experiment, i.e., many ARGoS
+ * processes in parallel, each of them evolving the same experiment with
+ * different GA hyperparameters (see sweep_design.h for the spec format).
+ *
+ * usage: kga_sweep <spec.json> [--workers <n>] [--dry-run]
+ *
+ * Each run is stored in <output>/run_<id>: the generated .argos file, the
+ * log of ARGoS and the results of the loop function. As soon as a run
+ * finishes, a row is appended to <output>/index.csv.
+ */
+
+#include "sweep_design.h"
+#include "work_queue.h"
+
+#include "loop_functions/population_archive.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+extern char** environ;
+
+/**
+ * @brief The RunResult struct
+ * Summary of a finished run, as stored in the index.
+ */
+struct RunResult {
+    QString status;
+    double seconds;
+    int lastGeneration;
+    float bestFitness;
+    float meanFitness;
+};
+
+// write a copy of the experiment with the run's settings
+static bool writeExperiment(const QString& src, const QString& dst, const SweepRun& run,
+                            const QString& resultsDir, QString& error)
+{
+    QFile in(src);
+    if (!in.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open %1").arg(src);
+        return false;
+    }
+    QFile out(dst);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QString("Unable to write %1").arg(dst);
+        return false;
+    }
+
+    QXmlStreamReader reader(&in);
+    QXmlStreamWriter writer(&out);
+    writer.setAutoFormatting(true);
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            const QString element = reader.name().toString();
+            // sweeps never open the visualization
+            if (element == "visualization") {
+                reader.skipCurrentElement();
+                continue;
+            }
+
+            QXmlStreamAttributes attributes = reader.attributes();
+            std::vector<std::pair<QString, QString> > values = run.values;
+            if (element == "loop_functions") {
+                values.push_back(std::make_pair(QString("loop_functions.mode"), QString("evolve")));
+                values.push_back(std::make_pair(QString("loop_functions.read_from_file"), QString("false")));
+                values.push_back(std::make_pair(QString("loop_functions.output_dir"), resultsDir));
+            }
+
+            writer.writeStartElement(reader.name().toString());
+            for (int i = 0; i < attributes.size(); ++i) {
+                const QString name = attributes.at(i).name().toString();
+                QString value = attributes.at(i).value().toString();
+                for (size_t v = 0; v < values.size(); ++v) {
+                    if (values[v].first == element + "." + name) {
+                        value = values[v].second;
+                        values[v].first.clear(); // done
+                    }
+                }
+                writer.writeAttribute(name, value);
+            }
+            // attributes which are not in the original file
+            for (size_t v = 0; v < values.size(); ++v) {
+                if (values[v].first.startsWith(element + ".")) {
+                    writer.writeAttribute(values[v].first.mid(element.size() + 1), values[v].second);
+                }
+            }
+        } else if (reader.isComment()) {
+            continue;
+        } else {
+            writer.writeCurrentToken(reader);
+        }
+    }
+
+    if (reader.hasError()) {
+        error = QString("Unable to parse %1: %2").arg(src).arg(reader.errorString());
+        return false;
+    }
+    return true;
+}
+
+// run ARGoS and wait for it; the output goes to 'logFile'
+static int runArgos(const QString& argos, const QString& experiment, const QString& logFile)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    const std::string log = logFile.toStdString();
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+
+    const std::string program = argos.toStdString();
+    const std::string xml = experiment.toStdString();
+    char* argv[] = { const_cast<char*>(program.c_str()), const_cast<char*>("-c"),
+                     const_cast<char*>(xml.c_str()), NULL };
+
+    pid_t pid;
+    int ret = posix_spawnp(&pid, program.c_str(), &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (ret != 0) {
+        return -1;
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// fitness of the last generation stored in the archive
+static bool readResults(const QString& resultsDir, RunResult& result)
+{
+    ArchiveReader archive;
+    if (!archive.open(QDir(resultsDir).filePath(ARCHIVE_FILENAME))) {
+        return false;
+    }
+    result.lastGeneration = archive.lastGeneration();
+    if (result.lastGeneration < 0) {
+        return false;
+    }
+
+    const uint32_t popSize = archive.header().popSize;
+    const float* fitness = archive.fitness(result.lastGeneration);
+    result.bestFitness = *std::max_element(fitness, fitness + popSize);
+    double sum = 0;
+    for (uint32_t i = 0; i < popSize; ++i) {
+        sum += fitness[i];
+    }
+    result.meanFitness = popSize ? sum / popSize : 0;
+    return true;
+}
+
+static RunResult execute(const SweepDesign& design, const SweepRun& run, const QString& runDir)
+{
+    RunResult result;
+    result.seconds = 0;
+    result.lastGeneration = -1;
+    result.bestFitness = 0;
+    result.meanFitness = 0;
+
+    const QString experiment = QDir(runDir).filePath("exp.argos");
+    const QString resultsDir = QDir(runDir).absoluteFilePath("results");
+    QString error;
+    if (!QDir(QDir::currentPath()).mkpath(runDir)
+            || !writeExperiment(design.experiment(), experiment, run, resultsDir, error)) {
+        std::cerr << "[ERROR] run " << run.id << ": " << qUtf8Printable(error) << std::endl;
+        result.status = "invalid";
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int ret = runArgos(design.argos(), experiment, QDir(runDir).filePath("argos.log"));
+    result.seconds = timer.elapsed() / 1000.0;
+
+    if (ret != 0) {
+        result.status = ret < 0 ? "crashed" : QString("exit_%1").arg(ret);
+    } else {
+        result.status = readResults(resultsDir, result) ? "ok" : "no_results";
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    QString specFile;
+    int workers = -1;
+    bool dryRun = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--workers") && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--dry-run")) {
+            dryRun = true;
+        } else if (argv[i][0] != '-' && specFile.isEmpty()) {
+            specFile = argv[i];
+        } else {
+            std::cerr << "usage: kga_sweep <spec.json> [--workers <n>] [--dry-run]" << std::endl;
+            return 1;
+        }
+    }
+    if (specFile.isEmpty()) {
+        std::cerr << "usage: kga_sweep <spec.json> [--workers <n>] [--dry-run]" << std::endl;
+        return 1;
+    }
+
+    SweepDesign design;
+    QString error;
+    if (!design.load(specFile, error)) {
+        std::cerr << "[FATAL] " << qUtf8Printable(error) << std::endl;
+        return 1;
+    }
+    if (workers >= 0) {
+        design.setWorkers(workers);
+    }
+    if (design.workers() == 0) {
+        design.setWorkers(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    std::vector<SweepRun> runs;
+    design.expand(runs);
+    const std::vector<QString> params = design.parameterNames();
+
+    std::cout << runs.size() << " runs, " << design.workers() << " workers" << std::endl;
+    if (dryRun) {
+        for (size_t r = 0; r < runs.size(); ++r) {
+            std::cout << "run_" << runs[r].id;
+            for (size_t v = 0; v < runs[r].values.size(); ++v) {
+                std::cout << " " << qUtf8Printable(runs[r].values[v].first)
+                          << "=" << qUtf8Printable(runs[r].values[v].second);
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    QDir output(design.output());
+    if (!QDir(QDir::currentPath()).mkpath(design.output())) {
+        std::cerr << "[FATAL] Unable to create " << qUtf8Printable(design.output()) << std::endl;
+        return 1;
+    }
+
+    QFile index(output.filePath("index.csv"));
+    if (!index.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "[FATAL] Unable to write " << qUtf8Printable(index.fileName()) << std::endl;
+        return 1;
+    }
+    QTextStream indexStream(&index);
+    indexStream << "run,repetition,status,seconds,last_generation,best_fitness,mean_fitness";
+    for (size_t p = 0; p < params.size(); ++p) {
+        indexStream << "," << params[p];
+    }
+    indexStream << ",directory\n";
+    indexStream.flush();
+
+    // the most expensive runs start first, so the sweep does not end
+    // waiting for a single long run; workers steal the remaining ones
+    std::vector<SweepRun> jobs(runs);
+    std::stable_sort(jobs.begin(), jobs.end(), [](const SweepRun& a, const SweepRun& b) {
+        return a.cost > b.cost;
+    });
+    WorkStealingQueue<SweepRun> queue(std::min<size_t>(design.workers(), jobs.size()));
+    queue.deal(jobs);
+
+    std::mutex indexMutex;
+    size_t finished = 0;
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < queue.workers(); ++w) {
+        threads.push_back(std::thread([&, w]() {
+            SweepRun run;
+            while (queue.take(w, run)) {
+                const QString runDir = output.filePath(QString("run_%1").arg(run.id));
+                const RunResult result = execute(design, run, runDir);
+
+                std::lock_guard<std::mutex> lock(indexMutex);
+                indexStream << run.id << "," << run.repetition << "," << result.status << ","
+                            << result.seconds << "," << result.lastGeneration << ","
+                            << result.bestFitness << "," << result.meanFitness;
+                for (size_t v = 0; v < run.values.size(); ++v) {
+                    indexStream << "," << run.values[v].second;
+                }
+                indexStream << "," << runDir << "\n";
+                indexStream.flush();
+
+                std::cout << "[" << ++finished << "/" << runs.size() << "] run_" << run.id
+                          << " " << qUtf8Printable(result.status) << " (" << result.seconds << "s)"
+                          << std::endl;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sweep_design.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+#include <cmath>
+#include <random>
+
+static QString toText(const QJsonValue& value)
+{
+    if (value.isString()) {
+        return value.toString();
+    }
+    if (value.isBool()) {
+        return value.toBool() ? "true" : "false";
+    }
+    return QString::number(value.toDouble(), 'g', 10);
+}
+
+static QString toText(double value, bool integer)
+{
+    return integer ? QString::number((qint64) std::llround(value)) : QString::number(value, 'g', 10);
+}
+
+SweepDesign::SweepDesign()
+    : m_sArgos("argos3")
+    , m_sOutput("sweep")
+    , m_bRandom(false)
+    , m_iSamples(10)
+    , m_iSeed(1)
+    , m_iRepetitions(1)
+    , m_iWorkers(0)
+{
+}
+
+bool SweepDesign::load(const QString& fileName, QString& error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open %1").arg(fileName);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        error = QString("Invalid sweep file %1: %2").arg(fileName).arg(parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject json = doc.object();
+    m_sExperiment = json.value("experiment").toString();
+    if (m_sExperiment.isEmpty()) {
+        error = "The sweep file must give the 'experiment' (.argos file)";
+        return false;
+    }
+    if (json.contains("argos")) m_sArgos = json.value("argos").toString();
+    if (json.contains("output")) m_sOutput = json.value("output").toString();
+    const int samples = json.value("samples").toInt(m_iSamples);
+    if (samples < 0) {
+        error = QString("Invalid number of samples (%1). Should be 0 or more.").arg(samples);
+        return false;
+    }
+    m_iSamples = samples;
+    m_iSeed = json.value("seed").toInt(m_iSeed);
+    m_iRepetitions = std::max(1, json.value("repetitions").toInt(m_iRepetitions));
+    m_iWorkers = std::max(0, json.value("workers").toInt(m_iWorkers));
+
+    const QString design = json.value("design").toString("grid");
+    if (design != "grid" && design != "random") {
+        error = QString("Invalid design '%1'. Should be 'grid' or 'random'.").arg(design);
+        return false;
+    }
+    m_bRandom = design == "random";
+
+    const QJsonObject parameters = json.value("parameters").toObject();
+    const QStringList names = parameters.keys();
+    m_parameters.clear();
+    for (int i = 0; i < names.size(); ++i) {
+        Parameter p;
+        p.name = names.at(i);
+        p.min = p.max = 0;
+        p.integer = false;
+        if (p.name.split(".").size() != 2) {
+            error = QString("Invalid parameter '%1'. Should be 'element.attribute'.").arg(p.name);
+            return false;
+        }
+
+        const QJsonValue value = parameters.value(p.name);
+        if (value.isArray()) {
+            const QJsonArray levels = value.toArray();
+            for (int l = 0; l < levels.size(); ++l) {
+                p.levels.push_back(toText(levels.at(l)));
+            }
+        } else if (value.isObject()) {
+            const QJsonObject range = value.toObject();
+            p.min = range.value("min").toDouble();
+            p.max = range.value("max").toDouble();
+            p.integer = range.value("integer").toBool(false);
+            // a grid needs levels; they are evenly spaced in [min, max]
+            if (!m_bRandom) {
+                const int steps = range.value("steps").toInt(2);
+                if (steps < 1) {
+                    error = QString("Invalid number of steps (%1) for parameter '%2'. Should be 1 or more.")
+                            .arg(steps).arg(p.name);
+                    return false;
+                }
+                for (int s = 0; s < steps; ++s) {
+                    const double v = steps > 1 ? p.min + (p.max - p.min) * s / (steps - 1) : p.min;
+                    p.levels.push_back(toText(v, p.integer));
+                }
+            }
+        } else {
+            p.levels.push_back(toText(value));
+        }
+
+        if (p.levels.empty() && !value.isObject()) {
+            error = QString("Parameter '%1' has no values").arg(p.name);
+            return false;
+        }
+        m_parameters.push_back(p);
+    }
+    return true;
+}
+
+std::vector<QString> SweepDesign::parameterNames() const
+{
+    std::vector<QString> names;
+    for (size_t i = 0; i < m_parameters.size(); ++i) {
+        names.push_back(m_parameters[i].name);
+    }
+    if (m_iRepetitions > 1) {
+        names.push_back("experiment.random_seed");
+    }
+    return names;
+}
+
+void SweepDesign::expand(std::vector<SweepRun>& runs) const
+{
+    // the settings of each run (without repetitions)
+    std::vector<std::vector<QString> > settings;
+    if (m_bRandom) {
+        std::mt19937 rng(m_iSeed);
+        for (uint32_t s = 0; s < m_iSamples; ++s) {
+            std::vector<QString> values;
+            for (size_t i = 0; i < m_parameters.size(); ++i) {
+                const Parameter& p = m_parameters[i];
+                if (!p.levels.empty()) {
+                    std::uniform_int_distribution<size_t> pick(0, p.levels.size() - 1);
+                    values.push_back(p.levels[pick(rng)]);
+                } else {
+                    std::uniform_real_distribution<double> uniform(p.min, p.max);
+                    values.push_back(toText(uniform(rng), p.integer));
+                }
+            }
+            settings.push_back(values);
+        }
+    } else {
+        // cartesian product; the last parameter changes faster
+        std::vector<size_t> level(m_parameters.size(), 0);
+        while (true) {
+            std::vector<QString> values;
+            for (size_t i = 0; i < m_parameters.size(); ++i) {
+                values.push_back(m_parameters[i].levels[level[i]]);
+            }
+            settings.push_back(values);
+
+            int i = (int) m_parameters.size() - 1;
+            for (; i >= 0; --i) {
+                if (++level[i] < m_parameters[i].levels.size()) break;
+                level[i] = 0;
+            }
+            if (i < 0) break;
+        }
+    }
+
+    runs.clear();
+    for (size_t s = 0; s < settings.size(); ++s) {
+        for (uint32_t rep = 0; rep < m_iRepetitions; ++rep) {
+            SweepRun run;
+            run.id = runs.size();
+            run.repetition = rep;
+            run.cost = 1;
+            for (size_t i = 0; i < m_parameters.size(); ++i) {
+                run.values.push_back(std::make_pair(m_parameters[i].name, settings[s][i]));
+                // the cost grows with these settings
+                const QString& name = m_parameters[i].name;
+                if (name.endsWith(".population_size") || name.endsWith(".generations")
+                        || name.endsWith(".trials") || name.endsWith(".lut_size")) {
+                    run.cost *= std::max(1.0, settings[s][i].toDouble());
+                }
+            }
+            if (m_iRepetitions > 1) {
+                run.values.push_back(std::make_pair(QString("experiment.random_seed"),
+                                                    QString::number(rep + 1)));
+            }
+            runs.push_back(run);
+        }
+    }
+}
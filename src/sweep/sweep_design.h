@@ -0,0 +1,105 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SWEEP_DESIGN_H
+#define SWEEP_DESIGN_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include <QString>
+
+/**
+ * @brief The SweepRun struct
+ * A single run of a sweep, i.e., the values given to some XML attributes.
+ */
+struct SweepRun {
+    uint32_t id;
+    uint32_t repetition;
+    std::vector<std::pair<QString, QString> > values; // 'element.attribute' -> value
+    double cost; // rough estimate, only used to start the longest runs first
+};
+
+/**
+ * @brief The SweepDesign class
+ * Describes a parameter sweep (loaded from a json file), e.g.,
+ *
+ *   {
+ *     "experiment": "experiments/demo.argos",
+ *     "design": "grid",          // or "random" (see 'samples' and 'seed')
+ *     "repetitions": 2,          // each run with a different random_seed
+ *     "workers": 0,              // concurrent runs (0 = one per core)
+ *     "argos": "argos3",
+ *     "output": "sweep",
+ *     "parameters": {
+ *       "loop_functions.population_size": [20, 50],
+ *       "loop_functions.mutation_rate": { "min": 0.0, "max": 0.1, "steps": 3 },
+ *       "params.lut_size": [22, 68]
+ *     }
+ *   }
+ *
+ * Parameters are named after the XML element and attribute they change
+ * (all elements with that name are changed). A grid design runs all the
+ * combinations of the levels; a random design draws 'samples' runs, picking
+ * a random level or a uniform value in [min, max] for each parameter
+ * ("integer": true rounds it).
+ * @author KilobotGA contributors
+ */
+class SweepDesign
+{
+
+public:
+    SweepDesign();
+
+    // return false and set the error message if something went wrong
+    bool load(const QString& fileName, QString& error);
+
+    // all runs of the sweep (including repetitions)
+    void expand(std::vector<SweepRun>& runs) const;
+
+    inline const QString& experiment() const { return m_sExperiment; }
+    inline const QString& argos() const { return m_sArgos; }
+    inline const QString& output() const { return m_sOutput; }
+    inline uint32_t workers() const { return m_iWorkers; }
+    inline void setWorkers(uint32_t workers) { m_iWorkers = workers; }
+
+    // names of the parameters, in the order they appear in the runs
+    std::vector<QString> parameterNames() const;
+
+private:
+    struct Parameter {
+        QString name;
+        std::vector<QString> levels; // empty for a range
+        double min;
+        double max;
+        bool integer;
+    };
+
+    QString m_sExperiment;
+    QString m_sArgos;
+    QString m_sOutput;
+    bool m_bRandom;
+    uint32_t m_iSamples;
+    uint32_t m_iSeed;
+    uint32_t m_iRepetitions;
+    uint32_t m_iWorkers;
+    std::vector<Parameter> m_parameters;
+};
+
+#endif // SWEEP_DESIGN_H
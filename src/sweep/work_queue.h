@@ -0,0 +1,84 @@
+/*
+ * KilobotGA
+ * Copyright (C) 2026 KilobotGA contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief The WorkStealingQueue class
+ * Each worker owns a deque of jobs. A worker takes jobs from the back of its
+ * own deque and, once it is empty, steals from the front of the others'.
+ * The jobs are never added after the workers start.
+ * @author KilobotGA contributors
+ */
+template <typename T>
+class WorkStealingQueue
+{
+
+public:
+    explicit WorkStealingQueue(size_t workers)
+        : m_queues(workers) {}
+
+    inline size_t workers() const { return m_queues.size(); }
+
+    // jobs are dealt round-robin, so give them in the order they should start
+    void deal(const std::vector<T>& jobs)
+    {
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            m_queues[i % m_queues.size()].jobs.push_front(jobs[i]);
+        }
+    }
+
+    // false when there is nothing left to do
+    bool take(size_t worker, T& job)
+    {
+        {
+            Queue& own = m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                job = own.jobs.back();
+                own.jobs.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < m_queues.size(); ++i) {
+            Queue& victim = m_queues[(worker + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = victim.jobs.front();
+                victim.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<T> jobs;
+    };
+    std::vector<Queue> m_queues;
+};
+
+#endif // WORK_QUEUE_H